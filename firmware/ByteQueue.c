@@ -4,7 +4,7 @@
 
 #include "ByteQueue.h"
 
-// these are needed only for reporting highwater mark
+// these are needed only for reporting statistics
 #include "CharString.h"
 #include "Console.h"
 #include "StringUtils.h"
@@ -46,14 +46,16 @@ bool ByteQueue_push (
 
         // increment length
         ++q->length;
-#if BYTEQUEUE_HIGHWATERMARK_ENABLED
         if (q->length > q->highwater) {
             q->highwater = q->length;
         }
-#endif
 
         push_successful = true;
         }
+    else
+        {
+        ++q->drops;
+        }
 
     SREG = SREGSave;
 
@@ -88,17 +90,17 @@ ByteQueueElement ByteQueue_pop (
     return byte;
 }
 
-#if BYTEQUEUE_HIGHWATERMARK_ENABLED
-extern void ByteQueue_reportHighwater (
+void ByteQueue_reportStatistics (
    PGM_P queueName,
    ByteQueue_t *q)
 {
-    CharString_define(20, msg);
+    CharString_define(32, msg);
     CharString_copyP(queueName, &msg);
     CharString_appendC(':', &msg);
-    StringUtils_appendDecimal(q->highwater, 1, 0, &msg);
+    StringUtils_appendDecimal(ByteQueue_highwater(q), 1, 0, &msg);
     CharString_appendC('/', &msg);
     StringUtils_appendDecimal(q->capacity, 1, 0, &msg);
+    CharString_appendP(PSTR(" d:"), &msg);
+    StringUtils_appendDecimal32(ByteQueue_drops(q), 1, 0, &msg);
     Console_printCS(&msg);
-}
-#endif
\ No newline at end of file
+}
\ No newline at end of file
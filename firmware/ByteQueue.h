@@ -14,6 +14,9 @@
 //    which defines static variable FromADH8066_Buffer with a capacity of
 //    300 bytes.
 //    Then you can use the other functions to push and pop bytes.
+//    Each queue keeps its high watermark and the number of bytes dropped
+//    because it was full, for sizing queues from field data. These are
+//    not reset by clear.
 //
 
 #ifndef BYTEQUEUE_LOADED
@@ -24,9 +27,6 @@
 #include <avr/pgmspace.h>
 #include <avr/interrupt.h>
 
-// enable/disable watermarking length of byte queues
-#define BYTEQUEUE_HIGHWATERMARK_ENABLED 0
-
 typedef uint8_t ByteQueueElement;
 
 typedef struct {
@@ -34,21 +34,14 @@ typedef struct {
     uint16_t tail;
     uint16_t length;
     uint16_t capacity;
-#if BYTEQUEUE_HIGHWATERMARK_ENABLED
     uint16_t highwater;
-#endif
+    uint16_t drops;     // bytes not pushed because the queue was full
     ByteQueueElement *bytes;
     } ByteQueue_t;
 
-#if BYTEQUEUE_HIGHWATERMARK_ENABLED
-#define ByteQueue_define(capacity, queueName, storage) \
-    storage ByteQueueElement queueName##_buf[capacity] = {0}; \
-    storage ByteQueue_t queueName = {0, 0, 0, capacity, 0, queueName##_buf};
-#else
 #define ByteQueue_define(capacity, queueName, storage) \
     storage ByteQueueElement queueName##_buf[capacity] = {0}; \
-    storage ByteQueue_t queueName = {0, 0, 0, capacity, queueName##_buf};
-#endif
+    storage ByteQueue_t queueName = {0, 0, 0, capacity, 0, 0, queueName##_buf};
 
 extern void ByteQueue_clear (
     ByteQueue_t *q);
@@ -129,7 +122,7 @@ inline ByteQueueElement ByteQueue_head (
 }
 
 // pushes a byte onto the tail of the queue, if it's not full. returns
-// true if successful
+// true if successful, otherwise counts the byte as dropped
 extern bool ByteQueue_push (
    const ByteQueueElement byte,
    ByteQueue_t *q);
@@ -138,7 +131,6 @@ extern bool ByteQueue_push (
 extern ByteQueueElement ByteQueue_pop (
    ByteQueue_t *q);
 
-#if BYTEQUEUE_HIGHWATERMARK_ENABLED
 // returns the high watermark of the queue
 inline uint16_t ByteQueue_highwater (
     const ByteQueue_t *q)
@@ -154,9 +146,24 @@ inline uint16_t ByteQueue_highwater (
     return len;
 }
 
-extern void ByteQueue_reportHighwater (
+// returns the number of bytes dropped because the queue was full
+inline uint16_t ByteQueue_drops (
+    const ByteQueue_t *q)
+{
+    char SREGSave;
+    SREGSave = SREG;
+    cli();
+
+    const uint16_t drops = q->drops;
+
+    SREG = SREGSave;
+
+    return drops;
+}
+
+// prints a line with the queue name, high watermark, capacity and drops
+extern void ByteQueue_reportStatistics (
    PGM_P queueName,
    ByteQueue_t *q);
-#endif
 
 #endif   // BYTEQUEUE_LOADED
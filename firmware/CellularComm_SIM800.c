@@ -12,6 +12,7 @@
 #include "MessageIDQueue.h"
 #include "CommandProcessor.h"
 #include "SoftwareSerialRx0.h"
+#include "UART_async.h"
 #include "TCPIPConsole.h"
 #include "Console.h"
 #include "EEPROMStorage.h"
@@ -103,7 +104,9 @@ static SystemTime_t powerupResumeTime;
 static bool needToEnterPIN;
 
 // variables for incoming SMS messages
+#if USE_CMGL
 static SystemTime_t nextCheckForIncomingSMSMessageTime;
+#endif
 static SMSMessageStatus CMGLSMSMessageStatus;
 static SMSMessageStatus incomingSMSMessageStatus;
 CharString_define(16, incomingSMSMessagePhoneNumber)
@@ -385,7 +388,11 @@ void CellularComm_Initialize (void)
     PINJUMPER_OUTPORT |= (1 << PINJUMPER_PIN);
 #endif
 
+#if UART_ASYNC_ENABLED
+    SIM800_Initialize(UART_rx_queue(), ps_d, PD3);
+#else
     SIM800_Initialize(SoftwareSerial_rx0Queue(), ps_b, 5);
+#endif
     CMGLSMSMessageStatus = sms_all; // initially clean out all messages
 
     // setup SIM800 response / prompt callbacks
@@ -50,6 +50,16 @@ typedef enum CellularTCPIPState_enum {
     cts_ipstateRequestDelay
 } CellularTCPIPState;
 
+#if CELLULARTCPIP_STATISTICS_ENABLED
+// timing of one phase (connect or send)
+typedef struct PhaseStatistics_struct {
+    uint16_t count;
+    uint16_t failures;
+    uint16_t lastTime;  // 1/100 s
+    uint16_t maxTime;   // 1/100 s
+} PhaseStatistics;
+#endif
+
 // state variables
 static CellularTCPIPState ctState = cts_idle;
 static SystemTime_t ipstateRequestDelayTime;
@@ -57,6 +67,9 @@ CharString_define(32, ctHostAddress);
 static uint16_t ctHostPort;
 static CellularTCPIP_DataProvider ctDataProvider;
 static CellularTCPIP_SendCompletionCallback ctSendCompletionCallback;
+static uint16_t ctDataLength;   // 0 if terminated by Ctrl-Z
+static uint16_t ctDataWritten;
+static uint16_t ctDataAccepted;
 static SystemTime_t ctResponseTimeoutTime;
 static SIM800_ResponseMessage SIM800ResponseMsg;
 static CellularTCPIPCommand curCommand;
@@ -67,6 +80,15 @@ static bool gprsIsAttached;
 static bool gotIPAddress;
 static bool gotPrompt;
 static bool gotDataAccept;
+static bool connectionStateTrusted;
+#if CELLULARTCPIP_STATISTICS_ENABLED
+static SystemTime_t phaseStartTime;
+static PhaseStatistics connectStatistics;
+static PhaseStatistics sendStatistics;
+#endif
+#if FAST_SEND_ENABLED
+static bool fastSend;
+#endif
 
 void responseMessageCallback (
     const SIM800_ResponseMessage msg)
@@ -112,13 +134,78 @@ static void setConnectionStatus (
     }
 }
 
+static void beginPhase (
+    const CellularTCPIPConnectionStatus newStatus)
+{
+#if CELLULARTCPIP_STATISTICS_ENABLED
+    SystemTime_getCurrentTime(&phaseStartTime);
+#endif
+    setConnectionStatus(newStatus);
+}
+
+#if CELLULARTCPIP_STATISTICS_ENABLED
+static void endPhase (
+    const bool successful,
+    PhaseStatistics *stats)
+{
+    SystemTime_t curTime;
+    SystemTime_getCurrentTime(&curTime);
+    const int32_t elapsed =
+        (SystemTime_diffSec(&curTime, &phaseStartTime) * 100) +
+        ((int16_t)curTime.hundredths - (int16_t)phaseStartTime.hundredths);
+    const uint16_t elapsedTime =
+        (elapsed < 0)
+        ? 0
+        : ((elapsed > 0x7FFF) ? 0x7FFF : ((uint16_t)elapsed));
+    ++stats->count;
+    if (!successful) {
+        ++stats->failures;
+    }
+    stats->lastTime = elapsedTime;
+    if (elapsedTime > stats->maxTime) {
+        stats->maxTime = elapsedTime;
+    }
+}
+
+static void reportPhase (
+    PGM_P phaseName,
+    const PhaseStatistics *stats)
+{
+    CharString_define(40, msg);
+    CharString_copyP(phaseName, &msg);
+    CharString_appendP(PSTR(" n:"), &msg);
+    StringUtils_appendDecimal(stats->count, 1, 0, &msg);
+    CharString_appendP(PSTR(" f:"), &msg);
+    StringUtils_appendDecimal(stats->failures, 1, 0, &msg);
+    CharString_appendP(PSTR(" t:"), &msg);
+    StringUtils_appendDecimal(stats->lastTime, 1, 2, &msg);
+    CharString_appendC('/', &msg);
+    StringUtils_appendDecimal(stats->maxTime, 1, 2, &msg);
+    Console_printCS(&msg);
+}
+#endif
+
 static void endSubtask (
     const CellularTCPIPConnectionStatus connStatus)
 {
+#if CELLULARTCPIP_STATISTICS_ENABLED
+    // a phase is only in progress if the subtask is active
+    switch ((ctState == cts_idle) ? c_none : curCommand) {
+        case c_connect :
+            endPhase(connStatus == cs_connected, &connectStatistics);
+            break;
+        case c_sendData :
+            endPhase(connStatus == cs_connected, &sendStatistics);
+            break;
+        default :
+            break;
+    }
+#endif
     if ((curCommand == c_sendData) && (ctSendCompletionCallback != 0)) {
         ctSendCompletionCallback(false);
     }
     setConnectionStatus(connStatus);
+    connectionStateTrusted = (connStatus == cs_connected);
     if (connStatus == cs_disconnected) {
         connStateChangeCallback = 0;
     }
@@ -212,6 +299,7 @@ static void promptCallback (
 static void dataAcceptCallback (
     const uint16_t dataSent)
 {
+    ctDataAccepted = dataSent;
     gotDataAccept = true;
 }
 static void sendCIPSEND (void)
@@ -220,7 +308,16 @@ static void sendCIPSEND (void)
     SIM800_setPromptCallback(promptCallback);
     gotDataAccept = false;
     SIM800_setDataAcceptCallback(dataAcceptCallback);
-    sendSIM800CommandP(PSTR("AT+CIPSEND"), cts_waitingForCIPSENDPrompt);
+    ctDataWritten = 0;
+    if (ctDataLength == 0) {
+        sendSIM800CommandP(PSTR("AT+CIPSEND"), cts_waitingForCIPSENDPrompt);
+    } else {
+        // fixed length. the module sends as soon as it has that many bytes
+        CharString_define(16, cipsend);
+        CharString_copyP(PSTR("AT+CIPSEND="), &cipsend);
+        StringUtils_appendDecimal(ctDataLength, 1, 0, &cipsend);
+        sendSIM800CommandCS(&cipsend, cts_waitingForCIPSENDPrompt);
+    }
 }
 
 static void sendCIPACK (void)
@@ -228,6 +325,19 @@ static void sendCIPACK (void)
     sendSIM800CommandP(PSTR("AT+CIPACK"), cts_waitingForCIPACKResponse);
 }
 
+static void beginSendData (void)
+{
+#if FAST_SEND_ENABLED
+    fastSend = connectionStateTrusted;
+    if (fastSend) {
+        // connection is known to be up. skip CIPSTATUS and CIPACK
+        sendCIPSEND();
+        return;
+    }
+#endif
+    requestIPState();
+}
+
 static void advanceStateForConnect (
     CharString_t *cmdBuffer)
 {
@@ -371,6 +481,7 @@ void CellularTCPIP_Initialize (void)
     curIPState = ips_unknown;
     gprsIsAttached = false;
     gotIPAddress = false;
+    connectionStateTrusted = false;
     resetSubtask();
     SIM800_setPDPDeactCallback(CellularTCPIP_notifyConnectionClosed);
 }
@@ -395,10 +506,12 @@ void CellularTCPIP_connect (
 
 void CellularTCPIP_sendData (
     CellularTCPIP_DataProvider provider,
+    const uint16_t dataLength,
     CellularTCPIP_SendCompletionCallback completionCallback)
 {
     if (provider != NULL) {
         ctDataProvider = provider;
+        ctDataLength = dataLength;
         ctSendCompletionCallback = completionCallback;
 
         curCommand = c_sendData;
@@ -412,6 +525,7 @@ void CellularTCPIP_disconnect (void)
 
 void CellularTCPIP_notifyConnectionClosed (void)
 {
+    connectionStateTrusted = false;
     if (ctState == cts_idle) {
         endSubtask(cs_disconnected);
     }
@@ -434,8 +548,8 @@ void CellularTCPIP_Subtask (void)
 #if DEBUG_TRACE
                         Console_printP(PSTR("sending data"));
 #endif
-                        setConnectionStatus(cs_sendingData);
-                        requestIPState();
+                        beginPhase(cs_sendingData);
+                        beginSendData();
                     } else  if (curCommand == c_disconnect) {
                         // close connection
 #if DEBUG_TRACE
@@ -450,7 +564,7 @@ void CellularTCPIP_Subtask (void)
 #if DEBUG_TRACE
                         Console_printP(PSTR("connecting TCPIP"));
 #endif
-                        setConnectionStatus(cs_connecting);
+                        beginPhase(cs_connecting);
 
                         // begin by checking registration
                         CellularComm_requestRegistrationStatus();
@@ -537,6 +651,13 @@ void CellularTCPIP_Subtask (void)
         case cts_waitingForCIPSENDPrompt :
             if (gotPrompt) {
                 ctState = cts_sendingData;
+#if FAST_SEND_ENABLED
+            } else if (fastSend && (SIM800ResponseMsg == rm_ERROR)) {
+                // cached connection state was stale. take the full path
+                fastSend = false;
+                connectionStateTrusted = false;
+                requestIPState();
+#endif
             } else if ((SIM800ResponseMsg == rm_ERROR) ||
                        (SIM800ResponseMsg == rm_CLOSED)) {
                 endSubtask(cs_disconnected);
@@ -545,8 +666,10 @@ void CellularTCPIP_Subtask (void)
         case cts_sendingData :
             if (ctDataProvider()) {
                 // completed providing data
-                SIM800_sendCtrlZ();
-                Console_printP(PSTR("sent Ctrl-Z"));
+                if (ctDataLength == 0) {
+                    SIM800_sendCtrlZ();
+                    Console_printP(PSTR("sent Ctrl-Z"));
+                }
                 SystemTime_futureTime(SEND_TIMEOUT, &ctResponseTimeoutTime);
                 ctState = cts_waitingForCIPSENDResponse;
             }
@@ -554,17 +677,20 @@ void CellularTCPIP_Subtask (void)
         case cts_waitingForCIPSENDResponse : {
             bool sendComplete = false;
             bool sendSuccessful = false;
-            bool timedOut = false;
-            if ((SIM800ResponseMsg == rm_SEND_OK) || gotDataAccept) {
+            if (SIM800ResponseMsg == rm_SEND_OK) {
                 sendComplete = true;
                 sendSuccessful = true;
+            } else if (gotDataAccept) {
+                // quick send mode (CIPQSEND=1). the module reports how
+                // many bytes it accepted
+                sendComplete = true;
+                sendSuccessful = (ctDataAccepted == ctDataWritten);
             } else if ((SIM800ResponseMsg == rm_SEND_FAIL) ||
                        (SIM800ResponseMsg == rm_ERROR) ||
                        (SIM800ResponseMsg == rm_CLOSED)) {
                 sendComplete = true;
             } else if (SystemTime_timeHasArrived(&ctResponseTimeoutTime)) {
                 sendComplete = true;
-                timedOut = true;
             }
             if (sendComplete) {
                 if (ctSendCompletionCallback != 0) {
@@ -634,6 +760,14 @@ int CellularTCPIP_state (void)
     return (int)ctState;
 }
 
+#if CELLULARTCPIP_STATISTICS_ENABLED
+void CellularTCPIP_reportStatistics (void)
+{
+    reportPhase(PSTR("connect"), &connectStatistics);
+    reportPhase(PSTR("send"), &sendStatistics);
+}
+#endif
+
 uint16_t CellularTCPIP_availableSpaceForWriteData (void)
 {
     return SIM800_availableSpaceForSend();
@@ -642,17 +776,20 @@ uint16_t CellularTCPIP_availableSpaceForWriteData (void)
 void CellularTCPIP_writeDataP (
     PGM_P data)
 {
+    ctDataWritten += strlen_P(data);
     SIM800_sendStringP(data);
 }
 
 void CellularTCPIP_writeDataCS (
     CharString_t *data)
 {
+    ctDataWritten += CharString_length(data);
     SIM800_sendStringCS(data);
 }
 
 void CellularTCPIP_writeDataCSS (
     CharStringSpan_t *data)
 {
+    ctDataWritten += CharStringSpan_length(data);
     SIM800_sendStringCSS(data);
 }
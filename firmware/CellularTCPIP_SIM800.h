@@ -15,6 +15,21 @@
 #include "CharString.h"
 #include "SIM800.h"
 
+// when set to 1, sends go straight to CIPSEND as long as no CLOSED or
+// PDP DEACT has been seen since the last successful exchange. Falls
+// back to CIPSTATUS (and CIPACK) if CIPSEND fails. can be set from the
+// compiler command line, e.g. to compare send times (see host/makefile)
+#ifndef FAST_SEND_ENABLED
+#define FAST_SEND_ENABLED 1
+#endif
+
+// when set to 1, the connect and send phases are timed and the results
+// can be printed with CellularTCPIP_reportStatistics. can be set from the
+// compiler command line
+#ifndef CELLULARTCPIP_STATISTICS_ENABLED
+#define CELLULARTCPIP_STATISTICS_ENABLED 0
+#endif
+
 // TCP/IP connection status
 typedef enum CellularTCPIPConnectionStatus_enum {
     cs_connecting,
@@ -40,8 +55,12 @@ extern void CellularTCPIP_connect (
     SIM800_IPDataCallback receiver,    // will be called when data from host arrives 
     CellularTCPIP_ConnectionStateChangeCallback stateChangeCallback);
 
+// if dataLength is nonzero the provider must write exactly that many
+// bytes, which are sent with AT+CIPSEND=<dataLength>. Otherwise the
+// data is terminated with Ctrl-Z
 extern void CellularTCPIP_sendData (
     CellularTCPIP_DataProvider provider,   // will be called to write data
+    const uint16_t dataLength,
     CellularTCPIP_SendCompletionCallback completionCallback);
 
 extern void CellularTCPIP_disconnect (void);
@@ -54,6 +73,12 @@ extern void CellularTCPIP_Subtask (void);
 
 extern int CellularTCPIP_state (void);
 
+#if CELLULARTCPIP_STATISTICS_ENABLED
+// prints count, failures, and last/max duration (1/100 s) of the connect
+// and send phases to the console
+extern void CellularTCPIP_reportStatistics (void);
+#endif
+
 // these functions are to be called only by DataProvider
 // functions
 extern uint16_t CellularTCPIP_availableSpaceForWriteData (void);
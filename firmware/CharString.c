@@ -71,7 +71,7 @@ void CharString_appendSubstringCS (
         (remainingCapacity < substrLen)
         ? remainingCapacity
         : substrLen;
-    strncpy(destStr->body + destStr->length, substrBegin, charsToAppend);
+    memcpy(destStr->body + destStr->length, substrBegin, charsToAppend);
     destStr->length += charsToAppend;
     destStr->body[destStr->length] = 0;
 }
@@ -10,10 +10,8 @@
 #include <avr/pgmspace.h>
 #include <avr/power.h>
 
-#if BYTEQUEUE_HIGHWATERMARK_ENABLED
 #include "SoftwareSerialRx0.h"
 #include "SoftwareSerialTx.h"
-#endif
 #include "SystemTime.h"
 #include "CellularComm_SIM800.h"
 #include "CellularTCPIP_SIM800.h"
@@ -23,10 +21,14 @@
 #include "WaterLevelDisplay.h"
 #include "StringUtils.h"
 #include "UART_async.h"
+#include "SIM800.h"
 #include "TFT_HXD8357D.h"
 #include "PowerMonitor.h"
 #include "SDCard.h"
 #include "Display.h"
+#include "TaskScheduler.h"
+#include "USBTerminal.h"
+#include "ConnectScheduler.h"
 
 typedef void (*StringProvider)(
     CharString_t *string);
@@ -44,13 +46,72 @@ static char idP[]               PROGMEM = "id";
 static char ipserverP[]         PROGMEM = "ipserver";
 static char tCalOffsetP[]       PROGMEM = "tCalOffset";
 static char utcOffsetP[]        PROGMEM = "utcOffset";
-static char batCalP[]           PROGMEM = "batCal";
 static char wlmTimeoutP[]       PROGMEM = "wlmTimeout";
 static char rebootP[]           PROGMEM = "reboot";
-static char sampleIntervalP[]   PROGMEM = "sampleInterval";
 static char logIntervalP[]      PROGMEM = "logInterval";
 static char logDelayP[]         PROGMEM = "logDelay";
+#if EEPROMStorage_supportThingspeak
 static char thingspeakP[]       PROGMEM = "thingspeak";
+#endif
+#if CONNECTSCHEDULER_ENABLED
+static char minCSQP[]           PROGMEM = "minCSQ";
+static char retryDelayP[]       PROGMEM = "retryDelay";
+static char maxBackoffP[]       PROGMEM = "maxBackoff";
+static char cheapConnectP[]     PROGMEM = "cheapConnect";
+#endif
+
+#if COMMANDPROCESSOR_DIAGNOSTICS_ENABLED
+// time between queue report lines, in system ticks
+#define QUEUE_REPORT_LINE_INTERVAL (SYSTEMTIME_TICKS_PER_SECOND / 100)
+#if UART_ASYNC_ENABLED
+#define NUM_QUEUE_REPORT_LINES 4
+#else
+#define NUM_QUEUE_REPORT_LINES 6
+#endif
+
+// state variables
+static uint8_t queueReportLine = NUM_QUEUE_REPORT_LINES; // next line to report
+static uint16_t nextQueueReportTicks;
+
+static void reportQueueLine (
+    const uint8_t line)
+{
+    switch (line) {
+        case 0 :
+        case 1 :
+            USBTerminal_reportQueue(line);
+            break;
+#if UART_ASYNC_ENABLED
+        case 2 :
+        case 3 :
+            UART_reportQueue(line - 2);
+            break;
+#else
+        case 2 :
+        case 3 :
+            SoftwareSerialRx0_reportQueue(line - 2);
+            break;
+        case 4 :
+        case 5 :
+            SoftwareSerialTx_reportQueue(line - 4);
+            break;
+#endif
+    }
+}
+#endif
+
+void CommandProcessor_task (void)
+{
+#if COMMANDPROCESSOR_DIAGNOSTICS_ENABLED
+    // print multi-line reports one line at a time so they don't overflow
+    // the USB transmit queue
+    if ((queueReportLine < NUM_QUEUE_REPORT_LINES) &&
+        (((int16_t)(SystemTime_ticks() - nextQueueReportTicks)) >= 0)) {
+        reportQueueLine(queueReportLine++);
+        nextQueueReportTicks = SystemTime_ticks() + QUEUE_REPORT_LINE_INTERVAL;
+    }
+#endif
+}
 
 void CommandProcessor_createStatusMessage (
     CharString_t *msg)
@@ -85,6 +146,8 @@ void CommandProcessor_createStatusMessage (
     CharString_appendC('-', msg);
     StringUtils_appendDecimal(maxTicks, 1, 0, msg);
     SystemTime_resetTaskTickRange();
+    CharString_appendP(PSTR(",U:"), msg);
+    StringUtils_appendDecimal32(USBTerminal_takeBytesSent(), 1, 0, msg);
     CharString_appendP(PSTR("  "), msg);
 }
 
@@ -281,6 +344,28 @@ bool CommandProcessor_executeCommand (
             if (validCommand) {
                 EEPROMStorage_setLoggingUpdateDelay(loggingUpdateDelay);
             }
+#if CONNECTSCHEDULER_ENABLED
+        } else if (CharStringSpan_equalsNocaseP(&cmdToken, minCSQP)) {
+            const uint8_t minCSQ = scanIntegerToken(&cmd, &validCommand);
+            if (validCommand) {
+                ConnectScheduler_setMinCSQ(minCSQ);
+            }
+        } else if (CharStringSpan_equalsNocaseP(&cmdToken, retryDelayP)) {
+            const uint16_t retryDelay = scanIntegerToken(&cmd, &validCommand);
+            if (validCommand) {
+                ConnectScheduler_setRetryDelay(retryDelay);
+            }
+        } else if (CharStringSpan_equalsNocaseP(&cmdToken, maxBackoffP)) {
+            const uint8_t maxBackoff = scanIntegerToken(&cmd, &validCommand);
+            if (validCommand) {
+                ConnectScheduler_setMaxBackoff(maxBackoff);
+            }
+        } else if (CharStringSpan_equalsNocaseP(&cmdToken, cheapConnectP)) {
+            const uint16_t cheapConnectTime = scanIntegerToken(&cmd, &validCommand);
+            if (validCommand) {
+                ConnectScheduler_setCheapConnectTime(cheapConnectTime);
+            }
+#endif
 #if EEPROMStorage_supportThingspeak
         } else if (CharStringSpan_equalsNocaseP(&cmdToken, thingspeakP)) {
             StringUtils_scanToken(&cmd, &cmdToken);
@@ -347,6 +432,18 @@ bool CommandProcessor_executeCommand (
             continueJSON(reply);
             appendJSONIntValue(PSTR("Delay"), EEPROMStorage_LoggingUpdateDelay(), reply);
             endJSON(reply);
+#if CONNECTSCHEDULER_ENABLED
+        } else if (CharStringSpan_equalsNocaseP(&cmdToken, PSTR("sched"))) {
+            beginJSON(reply);
+            appendJSONIntValue(minCSQP, ConnectScheduler_minCSQ(), reply);
+            continueJSON(reply);
+            appendJSONIntValue(retryDelayP, ConnectScheduler_retryDelay(), reply);
+            continueJSON(reply);
+            appendJSONIntValue(maxBackoffP, ConnectScheduler_maxBackoff(), reply);
+            continueJSON(reply);
+            appendJSONIntValue(cheapConnectP, ConnectScheduler_cheapConnectTime(), reply);
+            endJSON(reply);
+#endif
 #if EEPROMStorage_supportThingspeak
         } else if (CharStringSpan_equalsNocaseP(&cmdToken, thingspeakP)) {
             beginJSON(reply);
@@ -381,6 +478,42 @@ bool CommandProcessor_executeCommand (
         } else {
             validCommand = false;
         }
+#if WATERLEVELDISPLAY_SESSION_ENABLED
+    } else if (CharStringSpan_equalsNocaseP(&cmdToken, PSTR("session"))) {
+        // keep the connection up while mains power is on
+        StringUtils_scanToken(&cmd, &cmdToken);
+        if (CharStringSpan_equalsNocaseP(&cmdToken, onP)) {
+            WaterLevelDisplay_setPersistentSession(true);
+        } else if (CharStringSpan_equalsNocaseP(&cmdToken, offP)) {
+            WaterLevelDisplay_setPersistentSession(false);
+        } else {
+            validCommand = false;
+        }
+#endif
+#if WATERLEVELDISPLAY_BINARY_TELEMETRY_ENABLED
+    } else if (CharStringSpan_equalsNocaseP(&cmdToken, PSTR("telemetry"))) {
+        // sample format. the host selects binary if it understands it
+        StringUtils_scanToken(&cmd, &cmdToken);
+        if (CharStringSpan_equalsNocaseP(&cmdToken, PSTR("binary"))) {
+            WaterLevelDisplay_setBinaryTelemetry(true);
+        } else if (CharStringSpan_equalsNocaseP(&cmdToken, PSTR("text"))) {
+            WaterLevelDisplay_setBinaryTelemetry(false);
+        } else {
+            validCommand = false;
+        }
+#endif
+#if SAMPLEHISTORY_ENABLED
+    } else if (CharStringSpan_equalsNocaseP(&cmdToken, PSTR("history"))) {
+        // send the sample history with each sample
+        StringUtils_scanToken(&cmd, &cmdToken);
+        if (CharStringSpan_equalsNocaseP(&cmdToken, onP)) {
+            WaterLevelDisplay_setHistoryUpload(true);
+        } else if (CharStringSpan_equalsNocaseP(&cmdToken, offP)) {
+            WaterLevelDisplay_setHistoryUpload(false);
+        } else {
+            validCommand = false;
+        }
+#endif
     } else if (CharStringSpan_equalsNocaseP(&cmdToken, PSTR("sms"))) {
         // get number to send to
         CharStringSpan_t recipientNumber;
@@ -402,13 +535,26 @@ bool CommandProcessor_executeCommand (
         } else {
             validCommand = false;
         }
-#if BYTEQUEUE_HIGHWATERMARK_ENABLED
-    } else if (CharStringSpan_equalsNocaseP(&cmdToken, PSTR("bqhw"))) {
-        // byte queue report highwater
-        SoftwareSerialRx0_reportHighwater();
-        SoftwareSerialRx2_reportHighwater();
-        SoftwareSerialTx_reportHighwater();
-        UART_reportHighwater();
+#if COMMANDPROCESSOR_DIAGNOSTICS_ENABLED
+    } else if (CharStringSpan_equalsNocaseP(&cmdToken, PSTR("queues"))) {
+        // report high watermark and drops of every byte queue, one line
+        // per CommandProcessor_task call
+        queueReportLine = 0;
+#endif
+#if CONNECTSCHEDULER_ENABLED
+    } else if (CharStringSpan_equalsNocaseP(&cmdToken, PSTR("sched"))) {
+        // report connect outcomes used for scheduling
+        ConnectScheduler_reportStatistics();
+#endif
+#if CELLULARTCPIP_STATISTICS_ENABLED
+    } else if (CharStringSpan_equalsNocaseP(&cmdToken, PSTR("ipstats"))) {
+        // report connect and send timings
+        CellularTCPIP_reportStatistics();
+#endif
+#if TASKSCHEDULER_PROFILING_ENABLED
+    } else if (CharStringSpan_equalsNocaseP(&cmdToken, PSTR("prof"))) {
+        // report and reset per-task run counts and profile
+        TaskScheduler_reportStatistics();
 #endif
     } else if (CharStringSpan_equalsNocaseP(&cmdToken, rebootP)) {
         // reboot
@@ -419,7 +565,7 @@ bool CommandProcessor_executeCommand (
             beginJSON(reply);
             appendJSONIntValue(PSTR("EEAddr"), eeAddr, reply);
             continueJSON(reply);
-            appendJSONIntValue(PSTR("EEVal"), EEPROM_read((uint8_t*)eeAddr), reply);
+            appendJSONIntValue(PSTR("EEVal"), EEPROM_read((uint8_t*)(uintptr_t)eeAddr), reply);
             endJSON(reply);
         }
     } else if (CharStringSpan_equalsNocaseP(&cmdToken, PSTR("eewrite"))) {
@@ -427,7 +573,7 @@ bool CommandProcessor_executeCommand (
         if (validCommand) {
             const uint16_t eeValue = scanIntegerToken(&cmd, &validCommand);
             if (validCommand) {
-                EEPROM_write((uint8_t*)eeAddr, eeValue);
+                EEPROM_write((uint8_t*)(uintptr_t)eeAddr, eeValue);
             }
         }
     } else {
@@ -13,6 +13,13 @@
 #include <stddef.h>
 #include "CharStringSpan.h"
 
+// when set to 1, the "queues" command is built in. it only prints
+// diagnostics, so it's left out by default to save flash. can be set from
+// the compiler command line
+#ifndef COMMANDPROCESSOR_DIAGNOSTICS_ENABLED
+#define COMMANDPROCESSOR_DIAGNOSTICS_ENABLED 0
+#endif
+
 // buffer that clients can use to accumulate command characters
 extern CharString_t CommandProcessor_incomingCommand;
 
@@ -29,4 +36,7 @@ extern bool CommandProcessor_executeCommand (
     const CharStringSpan_t* command,
     CharString_t *reply);
 
+// prints pending report lines. call on every pass of the main loop
+extern void CommandProcessor_task (void);
+
 #endif  // COMMANDPROCESSOR_H
\ No newline at end of file
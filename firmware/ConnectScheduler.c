@@ -0,0 +1,197 @@
+//
+//  Connect Scheduler
+//
+//  Adjusts the connect schedule based on connect outcomes and signal quality
+//
+#include "ConnectScheduler.h"
+
+#include <avr/eeprom.h>
+#include "EEPROM_Util.h"
+#include "Console.h"
+#include "StringUtils.h"
+
+#if CONNECTSCHEDULER_ENABLED
+
+// signal quality reported when it is not known
+#define CSQ_UNKNOWN 99
+
+// attempts before the success ratio is trusted
+#define MIN_ATTEMPTS_FOR_RATIO 4
+
+// settings. kept here rather than in EEPROMStorage so that its layout is
+// not disturbed. erased (0xFF) means default
+static uint8_t minCSQEE EEMEM;
+static uint16_t retryDelayEE EEMEM;
+static uint8_t maxBackoffEE EEMEM;
+static uint16_t cheapConnectTimeEE EEMEM;
+
+// state variables
+static uint16_t attempts;
+static uint16_t successes;
+static uint8_t consecutiveFailures;
+static uint8_t lastSignalQuality;
+// running averages, each new value weighted 1/4
+static uint16_t averageConnectTime;     // seconds
+static uint8_t averageSignalQuality;
+static bool haveSignalQuality;
+
+void ConnectScheduler_Initialize (void)
+{
+    attempts = 0;
+    successes = 0;
+    consecutiveFailures = 0;
+    lastSignalQuality = CSQ_UNKNOWN;
+    averageConnectTime = 0;
+    averageSignalQuality = 0;
+    haveSignalQuality = false;
+}
+
+void ConnectScheduler_recordAttempt (
+    const bool successful,
+    const uint16_t connectTime,
+    const uint8_t signalQuality)
+{
+    ++attempts;
+    if (successful) {
+        ++successes;
+        consecutiveFailures = 0;
+        averageConnectTime = (successes == 1)
+            ? connectTime
+            : ((averageConnectTime * 3) + connectTime) / 4;
+    } else if (consecutiveFailures < 255) {
+        ++consecutiveFailures;
+    }
+    lastSignalQuality = signalQuality;
+    if (signalQuality != CSQ_UNKNOWN) {
+        averageSignalQuality = haveSignalQuality
+            ? ((averageSignalQuality * 3) + signalQuality) / 4
+            : signalQuality;
+        haveSignalQuality = true;
+    }
+}
+
+void ConnectScheduler_adjustNextConnectTime (
+    const SystemTime_t *curTime,
+    const uint16_t loggingInterval,
+    SystemTime_t *nextConnectTime)
+{
+    const uint8_t minCSQ = ConnectScheduler_minCSQ();
+    if (consecutiveFailures != 0) {
+        const bool goodSignal =
+            (lastSignalQuality != CSQ_UNKNOWN) &&
+            (lastSignalQuality >= minCSQ);
+        // connecting is cheap when it usually takes a small part of the
+        // time allowed for it, so a quick retry costs little
+        const bool cheapConnects =
+            (successes != 0) &&
+            (averageConnectTime <= ConnectScheduler_cheapConnectTime());
+        // most attempts fail, so back off one level further
+        const bool lowSuccessRatio =
+            (attempts >= MIN_ATTEMPTS_FOR_RATIO) &&
+            ((successes * 2) < attempts);
+        int16_t backoffLevel = consecutiveFailures;
+        backoffLevel -= (goodSignal ? 1 : 0) + (cheapConnects ? 1 : 0);
+        backoffLevel += (lowSuccessRatio ? 1 : 0);
+        if (backoffLevel <= 0) {
+            // first failure with good signal, or with connects that are
+            // quick to make. probably transient, so try again soon rather
+            // than waiting for the next interval
+            const uint16_t retryDelay = ConnectScheduler_retryDelay();
+            const uint32_t retryTime = curTime->seconds + retryDelay;
+            if ((retryDelay != 0) && (retryTime < nextConnectTime->seconds)) {
+                nextConnectTime->seconds = retryTime;
+                nextConnectTime->hundredths = 0;
+            }
+        } else {
+            // skip 1, 3, 7... intervals
+            const uint8_t maxBackoff = ConnectScheduler_maxBackoff();
+            const uint16_t intervalsToSkip =
+                (backoffLevel >= 8)
+                ? maxBackoff
+                : ((1 << backoffLevel) - 1);
+            nextConnectTime->seconds += ((uint32_t)loggingInterval) *
+                ((intervalsToSkip > maxBackoff) ? maxBackoff : intervalsToSkip);
+        }
+    } else if (haveSignalQuality && (averageSignalQuality < minCSQ)) {
+        // the last attempt worked, but signal is usually poor here, so
+        // attempts often burn the whole timeout. skip every other interval
+        // (the attempts keep the average up to date)
+        nextConnectTime->seconds += loggingInterval;
+    }
+}
+
+void ConnectScheduler_setMinCSQ (
+    const uint8_t minCSQ)
+{
+    EEPROM_write(&minCSQEE, minCSQ);
+}
+
+uint8_t ConnectScheduler_minCSQ (void)
+{
+    const uint8_t minCSQ = EEPROM_read(&minCSQEE);
+    return (minCSQ == 0xFF)
+        ? CONNECTSCHEDULER_DEFAULT_MIN_CSQ
+        : minCSQ;
+}
+
+void ConnectScheduler_setRetryDelay (
+    const uint16_t retryDelay)
+{
+    EEPROM_writeWord(&retryDelayEE, retryDelay);
+}
+
+uint16_t ConnectScheduler_retryDelay (void)
+{
+    const uint16_t retryDelay = EEPROM_readWord(&retryDelayEE);
+    return (retryDelay == 0xFFFF)
+        ? CONNECTSCHEDULER_DEFAULT_RETRY_DELAY
+        : retryDelay;
+}
+
+void ConnectScheduler_setMaxBackoff (
+    const uint8_t maxBackoff)
+{
+    EEPROM_write(&maxBackoffEE, maxBackoff);
+}
+
+uint8_t ConnectScheduler_maxBackoff (void)
+{
+    const uint8_t maxBackoff = EEPROM_read(&maxBackoffEE);
+    return (maxBackoff == 0xFF)
+        ? CONNECTSCHEDULER_DEFAULT_MAX_BACKOFF
+        : maxBackoff;
+}
+
+void ConnectScheduler_setCheapConnectTime (
+    const uint16_t cheapConnectTime)
+{
+    EEPROM_writeWord(&cheapConnectTimeEE, cheapConnectTime);
+}
+
+uint16_t ConnectScheduler_cheapConnectTime (void)
+{
+    const uint16_t cheapConnectTime = EEPROM_readWord(&cheapConnectTimeEE);
+    return (cheapConnectTime == 0xFFFF)
+        ? CONNECTSCHEDULER_DEFAULT_CHEAP_CONNECT_TIME
+        : cheapConnectTime;
+}
+
+void ConnectScheduler_reportStatistics (void)
+{
+    CharString_define(60, msg);
+    CharString_copyP(PSTR("sched n:"), &msg);
+    StringUtils_appendDecimal(attempts, 1, 0, &msg);
+    CharString_appendP(PSTR(" ok:"), &msg);
+    StringUtils_appendDecimal(successes, 1, 0, &msg);
+    CharString_appendP(PSTR(" cf:"), &msg);
+    StringUtils_appendDecimal(consecutiveFailures, 1, 0, &msg);
+    CharString_appendP(PSTR(" ct:"), &msg);
+    StringUtils_appendDecimal(averageConnectTime, 1, 0, &msg);
+    CharString_appendP(PSTR(" csq:"), &msg);
+    StringUtils_appendDecimal(lastSignalQuality, 1, 0, &msg);
+    CharString_appendC('/', &msg);
+    StringUtils_appendDecimal(averageSignalQuality, 1, 0, &msg);
+    Console_printCS(&msg);
+}
+
+#endif  // CONNECTSCHEDULER_ENABLED
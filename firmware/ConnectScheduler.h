@@ -0,0 +1,79 @@
+//
+//  Connect Scheduler
+//
+//  What it does:
+//    Adjusts when the next connection to the host is attempted, based on
+//    how recent connections went. After a failure with good signal, or
+//    when connections are usually quick to make, it retries soon. After
+//    repeated failures, or a failure with poor signal, it backs off by
+//    skipping logging intervals (1, 3, 7, ...) up to a limit, one level
+//    further when most attempts since power-up have failed. A successful
+//    connection restores the normal schedule, except that every other
+//    interval is skipped while the average signal quality is below the
+//    minimum.
+//    Keeps connect statistics (attempts, successes, average connect time
+//    and signal quality).
+//
+//  How to use it:
+//    Call ConnectScheduler_recordAttempt at the end of each connection
+//    attempt, then ConnectScheduler_adjustNextConnectTime on the next
+//    connect time computed from the logging interval.
+//    The settings are kept in EEPROM. Erased settings use the defaults.
+//
+#ifndef CONNECTSCHEDULER_H
+#define CONNECTSCHEDULER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "SystemTime.h"
+#include "CharString.h"
+
+// set to 1 to build in the adaptive schedule. when 0 the module is left
+// out and every logging interval is attempted, as before
+#ifndef CONNECTSCHEDULER_ENABLED
+#define CONNECTSCHEDULER_ENABLED 0
+#endif
+
+// setting defaults
+#define CONNECTSCHEDULER_DEFAULT_MIN_CSQ        8   // CSQ 0-31
+#define CONNECTSCHEDULER_DEFAULT_RETRY_DELAY    120 // seconds
+#define CONNECTSCHEDULER_DEFAULT_MAX_BACKOFF    7   // logging intervals
+#define CONNECTSCHEDULER_DEFAULT_CHEAP_CONNECT_TIME 30  // seconds
+
+extern void ConnectScheduler_Initialize (void);
+
+// connectTime is seconds from power-up of the modem until the connection
+// was ready, and is only used when successful
+extern void ConnectScheduler_recordAttempt (
+    const bool successful,
+    const uint16_t connectTime,
+    const uint8_t signalQuality);
+
+extern void ConnectScheduler_adjustNextConnectTime (
+    const SystemTime_t *curTime,
+    const uint16_t loggingInterval,
+    SystemTime_t *nextConnectTime);
+
+// lowest signal quality at which a failure is treated as transient, and
+// lowest average signal quality at which every interval is attempted
+extern void ConnectScheduler_setMinCSQ (
+    const uint8_t minCSQ);
+extern uint8_t ConnectScheduler_minCSQ (void);
+// seconds until the retry after a transient failure. 0 disables retries
+extern void ConnectScheduler_setRetryDelay (
+    const uint16_t retryDelay);
+extern uint16_t ConnectScheduler_retryDelay (void);
+// most logging intervals skipped when backing off
+extern void ConnectScheduler_setMaxBackoff (
+    const uint8_t maxBackoff);
+extern uint8_t ConnectScheduler_maxBackoff (void);
+// average connect time (seconds) at or below which a failure is retried
+// soon whatever the signal quality
+extern void ConnectScheduler_setCheapConnectTime (
+    const uint16_t cheapConnectTime);
+extern uint16_t ConnectScheduler_cheapConnectTime (void);
+
+// prints the connect statistics to the console
+extern void ConnectScheduler_reportStatistics (void);
+
+#endif  // CONNECTSCHEDULER_H
@@ -38,9 +38,9 @@ void Console_Initialize (void)
 
 void Console_task (void)
 {
-    ByteQueue_t* rxQueue = &FromUSB_Buffer;
-    if (!ByteQueue_is_empty(rxQueue)) {
-        char cmdByte = ByteQueue_pop(rxQueue);
+    SPSCByteQueue_t* rxQueue = &FromUSB_Buffer;
+    if (!SPSCByteQueue_is_empty(rxQueue)) {
+        char cmdByte = SPSCByteQueue_pop(rxQueue);
         switch (cmdByte) {
             case '\r' : {
                 // command complete. execute it
@@ -72,6 +72,8 @@ void Console_task (void)
         USBTerminal_sendCharsToHost(ESC_ERASE_LINE);
     }
 
+    CommandProcessor_task();
+
     // display status
     if (consoleIsConnected() &&
         SystemTime_timeHasArrived(&nextStatusPrintTime)) {
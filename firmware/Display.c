@@ -28,6 +28,9 @@
 
 #define WATER_GAP_AT_TOP 15
 #define WATER_HEIGHT (TANK_HEIGHT - (TANK_WALL_THICKNESS + WATER_GAP_AT_TOP))
+#define TANK_INTERIOR_X (TANK_X + TANK_WALL_THICKNESS)
+#define TANK_INTERIOR_WIDTH (TANK_WIDTH - (2 * TANK_WALL_THICKNESS))
+#define LEVEL_TEXT_X ((TANK_X + (TANK_WIDTH / 2)) - 20)
 
 // water level below this will be displayed on top of water
 #define WATER_TEXT_MIN_LEVEL 15
@@ -43,6 +46,10 @@ typedef enum RectangleState_enum {
     rs_drawTankOutline,
     rs_drawAir,
     rs_drawWater,
+    // when the tank has already been drawn, a level change only repaints
+    // the old level text and the band between the old and new water line
+    rs_eraseLevelText,
+    rs_drawLevelDelta,
     rs_done
 } RectangleState;
 
@@ -58,6 +65,9 @@ static int8_t lastDisplayedWaterLevel;
 static uint32_t waterLevelTimestamp;
 static uint32_t lastDisplayedWaterLevelTimestamp;
 static uint16_t waterY; // relative to top of tank
+static uint16_t displayedWaterY; // water line currently on the screen
+static uint16_t levelTextY;  // position of level text currently on the screen
+static uint8_t levelTextWidth;  // 0 if no level text is on the screen
 static uint32_t lastDisplayedTimeSeconds;
 static int16_t lastDisplayedTemperature;
 static uint8_t lastDisplayBatteryPercent;
@@ -115,25 +125,75 @@ static const TFT_HXD8357D_Rectangle* rectangleSource (void)
             }
             break;
         case rs_drawAir:
-            currentRectangle.x = TANK_X + TANK_WALL_THICKNESS;
+            currentRectangle.x = TANK_INTERIOR_X;
             currentRectangle.y = TANK_Y + WATER_GAP_AT_TOP;
-            currentRectangle.width = TANK_WIDTH - (2 * TANK_WALL_THICKNESS);
+            currentRectangle.width = TANK_INTERIOR_WIDTH;
             currentRectangle.height = waterY - WATER_GAP_AT_TOP;
             currentRectangle.color = HX8357_WHITE;
             rState = (waterLevel > 0) ? rs_drawWater : rs_done;
+            displayedWaterY = waterY;
             break;
         case rs_drawWater:
-            currentRectangle.x = TANK_X + TANK_WALL_THICKNESS;
+            currentRectangle.x = TANK_INTERIOR_X;
             currentRectangle.y = TANK_Y + waterY;
-            currentRectangle.width = TANK_WIDTH - (2 * TANK_WALL_THICKNESS);
+            currentRectangle.width = TANK_INTERIOR_WIDTH;
             currentRectangle.height = TANK_HEIGHT - (waterY + TANK_WALL_THICKNESS);
             currentRectangle.color = HX8357_BLUE;
             rState = rs_done;
+            displayedWaterY = waterY;
+            break;
+        case rs_eraseLevelText : {
+            // paint over the old text in the colors it will have once the
+            // new water line is drawn (air above the line, water below)
+            const uint16_t lineY = TANK_Y + waterY;
+            const uint16_t textBottom =
+                levelTextY + DisplayFonts_fontHeight(DisplayFonts_primary());
+            currentRectangle.x = LEVEL_TEXT_X;
+            currentRectangle.width = levelTextWidth;
+            if ((rSubState == 0) && (levelTextY < lineY)) {
+                // part above the new water line
+                currentRectangle.y = levelTextY;
+                currentRectangle.height =
+                    ((textBottom < lineY) ? textBottom : lineY) - levelTextY;
+                currentRectangle.color = HX8357_WHITE;
+                if (textBottom <= lineY) {
+                    rState = rs_drawLevelDelta;
+                }
+            } else {
+                // part below the new water line
+                currentRectangle.y = (levelTextY > lineY) ? levelTextY : lineY;
+                currentRectangle.height = textBottom - currentRectangle.y;
+                currentRectangle.color = HX8357_BLUE;
+                rState = rs_drawLevelDelta;
+            }
+            }
+            break;
+        case rs_drawLevelDelta :
+            currentRectangle.x = TANK_INTERIOR_X;
+            currentRectangle.width = TANK_INTERIOR_WIDTH;
+            if (waterY < displayedWaterY) {
+                // level rose - fill the band with water
+                currentRectangle.y = TANK_Y + waterY;
+                currentRectangle.height = displayedWaterY - waterY;
+                currentRectangle.color = HX8357_BLUE;
+            } else {
+                // level fell - fill the band with air
+                currentRectangle.y = TANK_Y + displayedWaterY;
+                currentRectangle.height = waterY - displayedWaterY;
+                currentRectangle.color = HX8357_WHITE;
+            }
+            rState = rs_done;
+            displayedWaterY = waterY;
             break;
         case rs_done :
             return NULL;
             break;
     }
+    if (currentRectangle.height == 0) {
+        // nothing to draw in this state. the level text has already been
+        // invalidated, so no other state will be skipped
+        return (rState == rs_done) ? NULL : rectangleSource();
+    }
     if (rState != prevRState) {
         // new state
         // reset substate
@@ -176,7 +236,7 @@ static const TFT_HXD8357D_Text* textSource (void)
         // water level changed
         lastDisplayedWaterLevel = waterLevel;
 
-        currentText.x = (TANK_X + (TANK_WIDTH / 2)) - 20;
+        currentText.x = LEVEL_TEXT_X;
         CharString_clear(&currentTextString);
         if (waterLevel >= 0) {
             currentText.y = TANK_Y + waterY;
@@ -192,6 +252,16 @@ static const TFT_HXD8357D_Text* textSource (void)
             CharString_appendC('?', &currentTextString);
         }
         CharStringSpan_init(&currentTextString, &currentText.chars);
+
+        // remember where the text is so that it can be erased on the next
+        // level change
+        levelTextY = currentText.y;
+        levelTextWidth = 0;
+        for (CharString_Iter iter = CharString_begin(&currentTextString);
+             iter != CharString_end(&currentTextString); ++iter) {
+            levelTextWidth +=
+                DisplayFonts_charWidth(DisplayFonts_primary(), *iter);
+        }
         if (waterLevel < WATER_TEXT_MIN_LEVEL) {
             currentText.bgColor = HX8357_WHITE;
             currentText.fgColor = HX8357_BLUE;
@@ -320,7 +390,15 @@ void Display_setWaterLevel (
         ? ((((uint16_t)(100 - waterLevel)) * WATER_HEIGHT) / 100)
         : WATER_HEIGHT) +
         WATER_GAP_AT_TOP;
-    rState = (waterLevel < 100) ? rs_drawAir : rs_drawWater;
+    if ((rState == rs_done) && (levelTextWidth != 0)) {
+        // tank is on the screen - only repaint what changed
+        rState = rs_eraseLevelText;
+        rSubState = 0;
+    } else if (rState >= rs_drawAir) {
+        // interior not drawn yet, or a partial update is in progress.
+        // repaint the whole interior
+        rState = (waterLevel < 100) ? rs_drawAir : rs_drawWater;
+    }
     lastDisplayedWaterLevel = -2;   // force update
     waterLevelTimestamp = *levelTimestamp;
 }
@@ -333,6 +411,8 @@ void Display_task (void)
             rSubState = 0;
             waterLevel = -1;
             waterY = WATER_HEIGHT + WATER_GAP_AT_TOP;
+            displayedWaterY = waterY;
+            levelTextWidth = 0;
             TFT_HXD8357D_setRectangleSource(rectangleSource);
             TFT_HXD8357D_setTextSource(textSource);
             dState = ds_idle;
@@ -41,3 +41,13 @@ uint8_t DisplayFonts_fontHeight (
 
     return yBottom - yTop;
 }
+
+uint8_t DisplayFonts_charWidth (
+    const GFXfont* font,
+    const char c)
+{
+    const uint8_t index = ((uint8_t)c) - (uint8_t)pgm_read_byte(&font->first);
+    const GFXglyph *glyph = &(((GFXglyph *)pgm_read_word(&font->glyph))[index]);
+
+    return pgm_read_byte(&glyph->xAdvance);
+}
@@ -18,5 +18,10 @@ extern const GFXfont* DisplayFonts_primary (void);
 extern uint8_t DisplayFonts_fontHeight (
     const GFXfont* font);
 
+// returns the horizontal advance of the given character, in pixels
+extern uint8_t DisplayFonts_charWidth (
+    const GFXfont* font,
+    const char c);
+
 #endif  /* DISPLAYFONTS_H */
 
@@ -32,6 +32,9 @@ extern void EEPROMStorage_setRebootInterval (
     const uint16_t rebootMinutes);
 extern uint16_t EEPROMStorage_rebootInterval (void);
 
+// watchdog timer period calibration, in percent of the nominal period
+extern uint8_t EEPROMStorage_watchdogTimerCal (void);
+
 extern void EEPROMStorage_setPIN (
     const CharStringSpan_t *PIN);
 extern void EEPROMStorage_getPIN (
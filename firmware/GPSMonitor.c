@@ -161,7 +161,7 @@ static void SendDataSubtask (void)
         case sdss_idle :
             if (haveGPSDataToSend && TCPIPConsole_readyToSend()) {
                 sendDataStatus = sds_sending;
-                TCPIPConsole_sendData(navDataSender, TCPIPSendCompletionCallaback);
+                TCPIPConsole_sendData(navDataSender, 0, TCPIPSendCompletionCallaback);
                 sdsState = sdss_sendingNavData;
             }
             break;
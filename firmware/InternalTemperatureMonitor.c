@@ -9,6 +9,7 @@
 #include "ADCManager.h"
 #include "SystemTime.h"
 #include "EEPROMStorage.h"
+#include "TaskScheduler.h"
 
 #define SENSOR_ADC_CHANNEL ADC_SINGLE_ENDED_INPUT_TEMP
 
@@ -16,7 +17,12 @@
 #define NUMERATOR ((int32_t)((1 / 0.94) * (1100 / 1024) * RESOLUTION))
 
 // sample every 10 seconds
-#define SENSOR_SAMPLE_TIME 500
+#define SENSOR_SAMPLE_TIME 1000
+
+// while a sample is in progress the task asks to run again after this
+// many ticks instead of its (long) scheduler period, so that it doesn't
+// hold the ADC
+#define ADC_POLL_TICKS (SYSTEMTIME_TICKS_PER_SECOND / 100)
 
 typedef enum {
     tms_idle,
@@ -69,6 +75,7 @@ void InternalTemperatureMonitor_task (void)
             if (SystemTime_timeHasArrived(&sampleTimer)) {
                 SystemTime_futureTime(SENSOR_SAMPLE_TIME, &sampleTimer);
                 tmState = tms_waitingForADCStart;
+                TaskScheduler_setCurrentTaskDelay(ADC_POLL_TICKS);
             }
             break;
         case tms_waitingForADCStart :
@@ -76,6 +83,7 @@ void InternalTemperatureMonitor_task (void)
                 // successfully started conversion
                 tmState = tms_waitingForADCCompletion;
             }
+            TaskScheduler_setCurrentTaskDelay(ADC_POLL_TICKS);
             break;    
         case tms_waitingForADCCompletion : {
             uint16_t temperature;
@@ -84,6 +92,8 @@ void InternalTemperatureMonitor_task (void)
                 haveValidSample = true;
 
                 tmState = tms_idle;
+            } else {
+                TaskScheduler_setCurrentTaskDelay(ADC_POLL_TICKS);
             }
             }
             break;
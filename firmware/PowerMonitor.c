@@ -11,9 +11,10 @@
 //      battery voltage).
 //
 //      The pump monitor uses an AC optoisolator. We sample the input pin
-//      every iteration and count when it is low (AC driving LEDs in
-//      optoisolator). If the pump is on we expect the input pin to be
-//      low at least twice during the sample period (50mS).
+//      each time the task runs (about every millisecond) and count when it
+//      is low (AC driving LEDs in optoisolator). If the pump is on we expect
+//      the input pin to be low at least twice during the sample period
+//      (50mS).
 //
 //  Pin usage:
 //     PF4 - input from optoisolator
@@ -89,6 +90,19 @@ void PowerMonitor_registerForNotification (
     notification = notificationFunction;
 }
 
+static void setState (
+    const bool newMainsOn,
+    const bool newPumpOn)
+{
+    if ((newMainsOn != mainsOn) || (newPumpOn != pumpOn)) {
+        mainsOn = newMainsOn;
+        pumpOn = newPumpOn;
+        if (notification != NULL) {
+            notification(mainsOn, pumpOn);
+        }
+    }
+}
+
 bool PowerMonitor_pumpOn (void)
 {
     return pumpOn;
@@ -106,7 +120,7 @@ static void pumpTask (void)
 
         if (numSamples >= 8) {
             // check for at least 2 samples asserted
-            pumpOn = (numAssertedSamples >= 2);
+            setState(mainsOn, (numAssertedSamples >= 2));
         }
 
         numSamples = 0;
@@ -137,7 +151,7 @@ static void mainsTask (void)
         case mts_waitingForADCCompletion : {
             uint16_t voltage;
             if (ADCManager_ConversionIsComplete(&voltage)) {
-                mainsOn = (voltage > MAINS_ON_ADC_VALUE);
+                setState((voltage > MAINS_ON_ADC_VALUE), pumpOn);
 
                 mtState = mts_idle;
             }
@@ -7,7 +7,7 @@
 //  I/O Pin usage
 //      D2        -> Power Status (optional)
 //      F1        -> OnKey
-//      Tx pin specified from SIM800_Initialize
+//      Tx pin specified from SIM800_Initialize (TXD1 with hardware UART)
 //      Rx pin not specified here, input comes from rxQ from SIM800_Initialize
 //
 #include "SIM800.h"
@@ -15,8 +15,9 @@
 #include <avr/io.h>
 #include <avr/interrupt.h>
 #include <stdlib.h>
-#include "ByteQueue.h"
+#include "SPSCByteQueue.h"
 #include "SoftwareSerialTx.h"
+#include "UART_async.h"
 #include "Console.h"
 #include "SystemTime.h"
 #include "StringUtils.h"
@@ -36,6 +37,20 @@
 
 #define RESPONSE_BUFFER_LENGTH 200
 
+// serial transmit to the SIM800, on whichever link is selected
+#if UART_ASYNC_ENABLED
+#define txAvailableSpace() UART_tx_space_remaining()
+#define txSendP(str) UART_write_stringP(str)
+#define txSendChar(ch) UART_write_byte(ch)
+#define txSendCSS(str) \
+    UART_write_bytes(CharStringSpan_begin(str), CharStringSpan_length(str))
+#else
+#define txAvailableSpace() SoftwareSerialTx_availableSpace(TX_CHAN_INDEX)
+#define txSendP(str) SoftwareSerialTx_sendP(TX_CHAN_INDEX, str)
+#define txSendChar(ch) SoftwareSerialTx_sendChar(TX_CHAN_INDEX, ch)
+#define txSendCSS(str) SoftwareSerialTx_sendCSS(TX_CHAN_INDEX, str)
+#endif
+
 char rmCLOSE_OK[]                   PROGMEM = "CLOSE OK";
 char rmCLOSED[]                     PROGMEM = "CLOSED";
 char rmCONNECT_FAIL[]               PROGMEM = "CONNECT FAIL";
@@ -159,6 +174,23 @@ PGM_P ipStateTable[] PROGMEM =
 };
 static const int ipStateTableSize = sizeof(ipStateTable) / sizeof(PGM_P);
 
+// tokenizer state for the response line being accumulated
+typedef enum lineTokenStateEnum {
+    lts_lineStart,
+    lts_prompt,         // got '>', expecting ' '
+    lts_plusName,       // got '+', reading name up to ':' (or ',' for +IPD)
+    lts_ipdLength,      // got "+IPD,", reading length up to ':'
+    lts_fields,         // reading the fields after "+XXX:"
+    lts_other
+} LineTokenState;
+
+// complete tokens that are not terminated by CR
+typedef enum nonterminatedTokenEnum {
+    nt_none,
+    nt_prompt,          // "> "
+    nt_ipData           // "+IPD,n:"
+} NonterminatedToken;
+
 typedef enum responseProcessorStateEnum {
     rps_interpret,
     rps_readIPData,
@@ -175,14 +207,23 @@ typedef enum moduleStateEnum {
 
 static bool powerCommand;
 static ModuleState mState;
-static ByteQueue_t* rxQueue;
+static SPSCByteQueue_t* rxQueue;
 CharString_define(RESPONSE_BUFFER_LENGTH, SIM800Response);
 SIM800_ResponseMessage responseMsg;
 static SystemTime_t powerRetryTime;
 static char prevInByte;
 static responseProcessorState rpState;
-static uint16_t ipDataLength;
+static uint16_t ipDataRemaining;   // bytes of the current +IPD still to come
 static PlusMessage latestPlusMessage;
+// tokenization and classification of the response line, updated as each
+// byte arrives
+static LineTokenState ltState;
+static uint8_t plusMessageArgsStart;    // offset of the fields after ':'
+static uint16_t ipdLength;
+static StringUtils_Lookup_t responseMessageLookup;
+static StringUtils_Lookup_t plusMessageLookup;
+static StringUtils_Lookup_t ipStateLookup;
+static bool isIPStateLine;
 static int16_t smsMsgID;
 CharString_define(10, smsMsgStatus);
 CharString_define(20, smsPhoneNumber);
@@ -477,14 +518,91 @@ static void readPDP (
     }
 }
 
+static void clearResponse (void)
+{
+    CharString_clear(&SIM800Response);
+    StringUtils_beginLookup(
+        SIM800_ResponseMessageTableSize, &responseMessageLookup);
+    StringUtils_beginLookup(plusMessageTableSize, &plusMessageLookup);
+    StringUtils_beginLookup(ipStateTableSize, &ipStateLookup);
+    ltState = lts_lineStart;
+    plusMessageArgsStart = 0;
+    isIPStateLine = false;
+}
+
+// tokenizes and classifies the response line in one pass, in constant time
+// per byte, as each byte is appended to it. recognizes the "> " prompt and
+// "+IPD,n:" header as soon as they are complete, splits "+XXX:" lines into
+// name and fields, and classifies the line against the response message,
+// plus message and IP state tables. by the time the line ends only the
+// results remain to be read
+static NonterminatedToken tokenizeResponseChar (
+    const char ch)
+{
+    NonterminatedToken token = nt_none;
+
+    const uint8_t position = responseMessageLookup.length;
+    StringUtils_lookupChar(
+        ch, SIM800_ResponseMessageTable, &responseMessageLookup);
+
+    switch (ltState) {
+        case lts_lineStart :
+            ltState = (ch == '>')
+                ? lts_prompt
+                : ((ch == '+') ? lts_plusName : lts_other);
+            break;
+        case lts_prompt :
+            if (ch == ' ') {
+                token = nt_prompt;
+            }
+            ltState = lts_other;
+            break;
+        case lts_plusName :
+            if (ch == ':') {
+                plusMessageArgsStart = position + 1;
+                ltState = lts_fields;
+            } else if (ch == ',') {
+                // the only name followed by ',' is IPD
+                ltState = ((position == 4) &&
+                           CharString_startsWithP(&SIM800Response, PSTR("+IPD,")))
+                    ? lts_ipdLength
+                    : lts_other;
+                ipdLength = 0;
+            } else {
+                StringUtils_lookupChar(ch, plusMessageTable, &plusMessageLookup);
+            }
+            break;
+        case lts_ipdLength :
+            if ((ch >= '0') && (ch <= '9')) {
+                ipdLength = (ipdLength * 10) + (ch - '0');
+            } else {
+                if ((ch == ':') && (position > 5)) {
+                    token = nt_ipData;
+                }
+                ltState = lts_other;
+            }
+            break;
+        case lts_fields :
+        case lts_other :
+            break;
+    }
+
+    // "STATE: XXX" - the state follows the prefix
+    if (isIPStateLine) {
+        StringUtils_lookupChar(ch, ipStateTable, &ipStateLookup);
+    } else if ((position == 6) && (ch == ' ')) {
+        isIPStateLine = CharString_startsWithP(&SIM800Response, PSTR("STATE: "));
+    }
+
+    return token;
+}
+
 static void processPlusMessage (
     CharStringSpan_t *plusMsg)
 {
-    // scan message identifier
-    CharStringSpan_t msg;
-    StringUtils_scanDelimitedString('+', ':', plusMsg, &msg, plusMsg);
-    const int msgIndex = StringUtils_lookupString(
-        &msg, plusMessageTable, plusMessageTableSize);
+    // the message identifier was classified as the line arrived
+    const int msgIndex = StringUtils_lookupResult(
+        plusMessageTable, plusMessageTableSize, &plusMessageLookup);
     latestPlusMessage = ((PlusMessage)msgIndex);
     switch (latestPlusMessage) {
         case pm_CBC     : readCBC(plusMsg);     break;
@@ -511,8 +629,8 @@ static void processPlusMessage (
 static void processIPState (
     const CharStringSpan_t *stateStr)
 {
-    const int msgIndex = StringUtils_lookupString(
-        stateStr, ipStateTable, ipStateTableSize);
+    const int msgIndex = StringUtils_lookupResult(
+        ipStateTable, ipStateTableSize, &ipStateLookup);
     const SIM800_IPState ipState = ((SIM800_IPState)msgIndex);
     if (ipStateCallback != 0) {
         ipStateCallback(ipState);
@@ -522,8 +640,9 @@ static void processIPState (
 static void processResponseMessage (
     const CharStringSpan_t *responseMsgStr)
 {
-    const int msgIndex = StringUtils_lookupString(
-        responseMsgStr, SIM800_ResponseMessageTable, SIM800_ResponseMessageTableSize);
+    const int msgIndex = StringUtils_lookupResult(
+        SIM800_ResponseMessageTable, SIM800_ResponseMessageTableSize,
+        &responseMessageLookup);
     responseMsg = ((SIM800_ResponseMessage)msgIndex);
     switch (responseMsg) {
         case rm_Call_Ready          :
@@ -579,9 +698,10 @@ static void interpretResponse (
         // look at first char
         const char firstChar = CharString_at(response, 0);
         if (firstChar == '+') {
-            CharStringSpan_t responseSpan;
-            CharStringSpan_init(response, &responseSpan);
-            processPlusMessage(&responseSpan);
+            // fields after the ':' (or the whole line if there is none)
+            CharStringSpan_t fieldsSpan;
+            CharStringSpan_initRight(response, plusMessageArgsStart, &fieldsSpan);
+            processPlusMessage(&fieldsSpan);
         } else if ((firstChar >= '0') && (firstChar <= '9')) {
             // TCP/IP address
 #if DEBUG_TRACE
@@ -591,15 +711,19 @@ static void interpretResponse (
             if (ipAddressCallback != 0) {
                 ipAddressCallback(response);
             }
-        } else if ((firstChar == 'S') && 
-                   CharString_startsWithP(response, PSTR("STATE: "))) {
+        } else if (isIPStateLine) {
             CharStringSpan_t ipStateStr;
             CharStringSpan_initRight(response, 7, &ipStateStr);
             processIPState(&ipStateStr);
         } else if ((firstChar == 'D') && 
                    CharString_startsWithP(response, PSTR("DATA ACCEPT:"))) {
             if (dataAcceptCallback != 0) {
-                dataAcceptCallback(0);  // TODO: need to read number
+                CharStringSpan_t acceptedStr;
+                CharStringSpan_initRight(response, 12, &acceptedStr);
+                bool isValid;
+                int16_t accepted;
+                StringUtils_scanInteger(&acceptedStr, &isValid, &accepted, NULL);
+                dataAcceptCallback(isValid ? accepted : 0);
             }
         } else {
             CharStringSpan_t responseSpan;
@@ -609,20 +733,16 @@ static void interpretResponse (
     }
 }
 
-// returns true if response is a complete non-terminated response:
+// acts on a complete non-terminated response, and returns true if there
+// was one:
 // "> " prompt
 // +IPD,n:... TCP/IP data
 //
 static bool interpretNonterminatedResponse (
-    const CharString_t *response)
+    const NonterminatedToken token)
 {
-    bool isNonterminatedResponse = false;
-
-    const int responseLength = CharString_length(response);
-    if (responseLength >= 2) {
-        const char firstChar = CharString_at(response, 0);
-        const char secondChar = CharString_at(response, 1);
-        if ((firstChar == '>') && (secondChar == ' ')) {
+    switch (token) {
+        case nt_prompt :
             // got prompt
 #if DEBUG_TRACE
             Console_printP(PSTR("Got prompt"));
@@ -630,35 +750,71 @@ static bool interpretNonterminatedResponse (
             if (promptCallback != 0) {
                 promptCallback();
             }
-            isNonterminatedResponse = true;
-        } else if ((firstChar == '+') &&
-                   (secondChar == 'I') && 
-                   (CharString_at(response, responseLength-1) == ':') &&
-                   (CharString_startsWithP(response, PSTR("+IPD,")))) {
-            // could be IP data
-            CharStringSpan_t ipdStr;
-            CharStringSpan_initRight(response, 5, &ipdStr);
-            bool isValidLength = false;
-            int16_t dataLength = 0;
-            StringUtils_scanInteger(&ipdStr, &isValidLength, &dataLength, &ipdStr);
-            if (isValidLength && (CharStringSpan_front(&ipdStr) == ':')) {
-                // getting TCP/IP data
-                ipDataLength = dataLength;
+            break;
+        case nt_ipData :
+            // getting TCP/IP data
+            ipDataRemaining = ipdLength;
+            if (ipDataRemaining > 0) {
                 rpState = rps_readIPData;
-                isNonterminatedResponse = true;
             }
-        }
+            break;
+        case nt_none :
+            break;
+    }
+
+    return token != nt_none;
+}
+
+// hands the IP data at the head of the rx queue to the IP data callback in
+// place, as one chunk of at most bytesAvailable bytes. returns the number
+// of bytes consumed
+static uint8_t deliverIPData (
+    const uint8_t bytesAvailable)
+{
+    const ByteQueueElement *data;
+    uint8_t chunkLength = SPSCByteQueue_peekSpan(rxQueue, &data);
+    if (chunkLength > bytesAvailable) {
+        chunkLength = bytesAvailable;
+    }
+    if (chunkLength > ipDataRemaining) {
+        chunkLength = ipDataRemaining;
+    }
+    ipDataRemaining -= chunkLength;
+
+    CharStringSpan_t chunk;
+    CharStringSpan_set((CharString_Iter)data,
+        (CharString_Iter)(data + chunkLength), &chunk);
+#if DEBUG_TRACE
+    Console_printP(PSTR("Got IP data:"));
+    Console_printCSS(&chunk);
+#endif
+    if (ipDataCallback != 0) {
+        ipDataCallback(&chunk, ipDataRemaining);
+    }
+
+    prevInByte = data[chunkLength - 1];
+    SPSCByteQueue_commitSpan(chunkLength, rxQueue);
+    if (ipDataRemaining == 0) {
+        // got all IP data
+        rpState = rps_interpret;
     }
 
-    return isNonterminatedResponse;
+    return chunkLength;
 }
 
 static void processResponseBytes (void)
 {
     ByteQueueElement inByte;
-    for (uint8_t numBytes = ByteQueue_length(rxQueue); numBytes > 0;
-            --numBytes) {
-        inByte = ByteQueue_pop(rxQueue);
+    uint8_t numBytes = SPSCByteQueue_length(rxQueue);
+    while (numBytes > 0) {
+        if (rpState == rps_readIPData) {
+            // IP data bypasses the response buffer
+            numBytes -= deliverIPData(numBytes);
+            continue;
+        }
+
+        inByte = SPSCByteQueue_pop(rxQueue);
+        --numBytes;
         switch (rpState) {
             case rps_interpret :
                 if (inByte == 13) {
@@ -673,36 +829,15 @@ static void processResponseBytes (void)
 #endif
 
                     interpretResponse(&SIM800Response);
-                    CharString_clear(&SIM800Response);
+                    clearResponse();
                 } else if (!((inByte == 10) && (prevInByte == 13))) {// discard LF if it immediately follows CR
                     CharString_appendC((char)inByte, &SIM800Response);
-                    if (interpretNonterminatedResponse(&SIM800Response)) {
-                        CharString_clear(&SIM800Response);
+                    if (interpretNonterminatedResponse(
+                            tokenizeResponseChar((char)inByte))) {
+                        clearResponse();
                     }
                 }
                 break;
-            case rps_readIPData :
-                CharString_appendC((char)inByte, &SIM800Response);
-                if (CharString_length(&SIM800Response) >= ipDataLength) {
-                    // got all IP data
-
-#if DEBUG_TRACE
-                    CharString_define(30, msg);
-                    CharString_copyP(PSTR("Got IP data ("), &msg);
-                    StringUtils_appendDecimal(ipDataLength, 0, 0, &msg);
-                    CharString_appendP(PSTR(") '"), &msg);
-                    CharString_appendCS(&SIM800Response, &msg);
-                    CharString_appendC('\'', &msg);
-                    Console_printCS(&msg);
-#endif
-
-                    if (ipDataCallback != 0) {
-                        ipDataCallback(&SIM800Response);
-                    }
-                    CharString_clear(&SIM800Response);
-                    rpState = rps_interpret;
-                }
-                break;
             case rps_raw :
                 if (inByte == 13) {
                     // got raw data line
@@ -718,7 +853,7 @@ static void processResponseBytes (void)
                                 smsMsgID, &smsMsgStatus, &smsPhoneNumber, &SIM800Response);
                         }
                     }
-                    CharString_clear(&SIM800Response);
+                    clearResponse();
                     rpState = rps_interpret;
                 } else if (!((inByte == 10) && (prevInByte == 13))) {// discard LF if it immediately follows CR
                     CharString_appendC((char)inByte, &SIM800Response);
@@ -766,7 +901,7 @@ void SIM800_powerOff (void)
 }
 
 void SIM800_Initialize (
-    ByteQueue_t *rxQ,
+    SPSCByteQueue_t *rxQ,
     IOPortBitfield_PortSelection txPort,
     uint8_t txPin)
 {
@@ -790,6 +925,7 @@ void SIM800_Initialize (
     responseMsg = rm_noResponseYet;
     prevInByte = 0;
     rpState = rps_interpret;
+    clearResponse();
 
     responseCallback = 0;
     ipStateCallback = 0;
@@ -809,8 +945,13 @@ void SIM800_Initialize (
     CBCCallback = 0;
     promptCallback = 0;
 
+#if UART_ASYNC_ENABLED
+    UART_init();
+    UART_set_baud_rate(SIM800_UART_BAUD_RATE);
+#else
     SoftwareSerialTx_open(TX_CHAN_INDEX, txPort, txPin);
     SoftwareSerialTx_enable(TX_CHAN_INDEX);
+#endif
 }
 
 void SIM800_task (void)
@@ -1028,7 +1169,7 @@ void SIM800_setPromptCallback (
 
 uint16_t SIM800_availableSpaceForSend (void)
 {
-    return SoftwareSerialTx_availableSpace(TX_CHAN_INDEX);
+    return txAvailableSpace();
 }
 
 void SIM800_sendStringP (
@@ -1038,33 +1179,35 @@ void SIM800_sendStringP (
     Console_printP(str);
 #endif
 
-    SoftwareSerialTx_sendP(TX_CHAN_INDEX, str);
+    txSendP(str);
 }
 
 void SIM800_sendStringCS (
     const CharString_t* str)
 {
-    SoftwareSerialTx_sendCS(TX_CHAN_INDEX, str);
+    CharStringSpan_t strSpan;
+    CharStringSpan_init(str, &strSpan);
+    txSendCSS(&strSpan);
 }
 
 void SIM800_sendStringCSS (
     const CharStringSpan_t* str)
 {
-    SoftwareSerialTx_sendCSS(TX_CHAN_INDEX, str);
+    txSendCSS(str);
 }
 
 void SIM800_sendLineP (
     PGM_P str)
 {
     SIM800_sendStringP(str);
-    SoftwareSerialTx_sendChar(TX_CHAN_INDEX, 13);
+    txSendChar(13);
 }
 
 void SIM800_sendLineCS (
     const CharString_t* str)
 {
-    SoftwareSerialTx_sendCS(TX_CHAN_INDEX, str);
-    SoftwareSerialTx_sendChar(TX_CHAN_INDEX, 13);
+    SIM800_sendStringCS(str);
+    txSendChar(13);
 }
 
 void SIM800_sendHex (
@@ -1073,8 +1216,8 @@ void SIM800_sendHex (
     const uint8_t* dataPtr = data;
     while (*dataPtr != 0) {
         const uint8_t chByte = *dataPtr++;
-        SoftwareSerialTx_sendChar(TX_CHAN_INDEX, nibbleHex(chByte >> 4));
-        SoftwareSerialTx_sendChar(TX_CHAN_INDEX, nibbleHex(chByte));
+        txSendChar(nibbleHex(chByte >> 4));
+        txSendChar(nibbleHex(chByte));
     }
 }
 
@@ -1087,14 +1230,14 @@ void SIM800_sendHexP (
         byte = pgm_read_byte(cp);
         ++cp;
         if (byte != 0) {
-            SoftwareSerialTx_sendChar(TX_CHAN_INDEX, nibbleHex(byte >> 4));
-            SoftwareSerialTx_sendChar(TX_CHAN_INDEX, nibbleHex(byte));
+            txSendChar(nibbleHex(byte >> 4));
+            txSendChar(nibbleHex(byte));
         }
     } while (byte != 0);
 }
 
 void SIM800_sendCtrlZ (void)
 {
-    SoftwareSerialTx_sendChar(TX_CHAN_INDEX, 26);
+    txSendChar(26);
 }
 
@@ -1,17 +1,26 @@
 //
 //  SIM800 Quad-band GSM/GPRS module interface
 //
-//  Uses SoftwareSerialTx channel 0
+//  Uses SoftwareSerialTx channel 0, or the hardware USART (UART_async)
+//  when UART_ASYNC_ENABLED
 //
 #ifndef SIM800_H
 #define SIM800_H
 
-#include "ByteQueue.h"
+#include "SPSCByteQueue.h"
 #include <avr/pgmspace.h>
 #include "CharStringSpan.h"
 #include "IOPortBitfield.h"
 #include <stdint.h>
 
+// the serial link to the SIM800 is selected by UART_ASYNC_ENABLED (see
+// UART_async.h). when 0 it is bit-banged through SoftwareSerialTx on the
+// Feather FONA pins (rx comes from the queue given to SIM800_Initialize,
+// normally SoftwareSerialRx0). when 1 it is the hardware USART at
+// SIM800_UART_BAUD_RATE. the SIM800 autobauds on the first AT, so no rate
+// setting is needed
+#define SIM800_UART_BAUD_RATE 57600
+
 typedef enum SIM800_moduleStatusEnum {
     SIM800_ms_off,
     SIM800_ms_initializing,
@@ -79,8 +88,14 @@ typedef void (*SIM800_IPStateCallback)(
     const SIM800_IPState ipState);
 typedef void (*SIM800_IPAddressCallback)(
     const CharString_t *ipAddress);
+// IP data (+IPD) is delivered as it arrives, in chunks that point into the
+// receive queue, so a payload of any length is passed through without
+// being buffered. remaining is the number of bytes of the payload still
+// to come after this chunk (0 on the last chunk). the chunk is only valid
+// during the call
 typedef void (*SIM800_IPDataCallback)(
-    const CharString_t *ipData);
+    const CharStringSpan_t *ipData,
+    const uint16_t remaining);
 typedef void (*SIM800_CIPACKCallback)(
     const SIM800_CIPACKData *cipackData);
 typedef void (*SIM800_DataAcceptCallback)(
@@ -114,7 +129,7 @@ typedef void (*SIM800_promptCallback)(
     void);
 
 extern void SIM800_Initialize (
-    ByteQueue_t *rxQ,
+    SPSCByteQueue_t *rxQ,
     IOPortBitfield_PortSelection txPort,
     uint8_t txPin);
 
@@ -10,6 +10,10 @@
 #define SS_PIN      PD6
 #define SS_DIR      DDRD
 
+// repeat engine state
+static uint8_t repeatHi;
+static uint8_t repeatLo;
+static uint32_t repeatRemaining;
 
 void SPIAsync_init (const uint16_t options)
 {
@@ -37,6 +41,8 @@ void SPIAsync_init (const uint16_t options)
 
     // enable SPI and set other options
     SPCR = ((1 << SPE) | (uint8_t)((options & 0xFF)));
+
+    repeatRemaining = 0;
 }
 
 void SPIAsync_assertSS (void)
@@ -49,3 +55,34 @@ void SPIAsync_deassertSS (void)
     SS_OUTPORT |= (1 << SS_PIN);
 }
 
+void SPIAsync_beginRepeat16 (
+    const uint16_t word,
+    const uint32_t count)
+{
+    repeatHi = word >> 8;
+    repeatLo = word & 0xFF;
+    repeatRemaining = count;
+}
+
+bool SPIAsync_continueRepeat16 (
+    const uint16_t maxWords)
+{
+    uint16_t burst =
+        (repeatRemaining > maxWords)
+        ? maxWords
+        : repeatRemaining;
+    repeatRemaining -= burst;
+
+    // keep the bytes in registers and poll SPIF directly so that the
+    // next byte goes out as soon as the previous one has been shifted
+    const uint8_t hi = repeatHi;
+    const uint8_t lo = repeatLo;
+    while (burst-- > 0) {
+        SPDR = hi;
+        while ((SPSR & (1 << SPIF)) == 0);
+        SPDR = lo;
+        while ((SPSR & (1 << SPIF)) == 0);
+    }
+
+    return repeatRemaining != 0;
+}
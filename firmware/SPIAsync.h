@@ -6,6 +6,9 @@
 //    Use SPIAsync_operationCompleted to determine if sendByte or requestByte
 //    have completed. This allows SPI transactions to be in progress while other
 //    processing takes place (doesn't block waiting for operations to complete).
+//    Also provides a repeat engine that sends a 16-bit word many times
+//    (e.g. a run of same-colored pixels) in bounded bursts, so that long runs
+//    can be spread across several mainloop iterations.
 //    Based on AtMega32U4 spec
 //
 //  How to use it:
@@ -102,4 +105,18 @@ inline bool SPIAsync_operationCompleted (void)
     return (SPSR & (1<<SPIF)) != 0;
 }
 
+// begins a run that sends the given 16-bit word (MSB first) count times.
+// Nothing is sent until SPIAsync_continueRepeat16 is called. Any preceding
+// operation must have completed.
+extern void SPIAsync_beginRepeat16 (
+    const uint16_t word,
+    const uint32_t count);
+
+// sends up to maxWords more words of the current run and waits for the
+// last byte to complete. returns true if the run has more words to send.
+// Note that this does not use the SPI interrupt: at FOSC/4 a byte takes
+// 32 cycles, which is less than the cost of entering and leaving an ISR.
+extern bool SPIAsync_continueRepeat16 (
+    const uint16_t maxWords);
+
 #endif  // SPIASYNC
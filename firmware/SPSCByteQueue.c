@@ -0,0 +1,110 @@
+//
+// Single-Producer Single-Consumer Byte Queue
+//
+
+#include "SPSCByteQueue.h"
+
+#include <string.h>
+
+// these are needed only for reporting statistics
+#include "CharString.h"
+#include "Console.h"
+#include "StringUtils.h"
+
+// out-of-line copies of the inline functions, for calls the compiler
+// doesn't inline
+extern inline uint8_t SPSCByteQueue_capacity (const SPSCByteQueue_t *q);
+extern inline uint8_t SPSCByteQueue_length (const SPSCByteQueue_t *q);
+extern inline uint8_t SPSCByteQueue_spaceRemaining (const SPSCByteQueue_t *q);
+extern inline bool SPSCByteQueue_is_empty (const SPSCByteQueue_t *q);
+extern inline bool SPSCByteQueue_is_full (const SPSCByteQueue_t *q);
+extern inline ByteQueueElement SPSCByteQueue_head (const SPSCByteQueue_t *q);
+extern inline bool SPSCByteQueue_push (const ByteQueueElement byte, SPSCByteQueue_t *q);
+extern inline ByteQueueElement SPSCByteQueue_pop (SPSCByteQueue_t *q);
+extern inline uint8_t SPSCByteQueue_peekSpan (const SPSCByteQueue_t *q, const ByteQueueElement **span);
+extern inline void SPSCByteQueue_commitSpan (const uint8_t count, SPSCByteQueue_t *q);
+
+void SPSCByteQueue_clear (
+    SPSCByteQueue_t *q)
+    {
+    q->head = 0;
+    q->tail = 0;
+    }
+
+uint8_t SPSCByteQueue_pushBlock (
+    const ByteQueueElement *bytes,
+    const uint8_t count,
+    SPSCByteQueue_t *q)
+{
+    const uint8_t tail = q->tail;
+    const uint8_t length = tail - q->head;
+    const uint8_t space = q->capacity - length;
+    const uint8_t numToPush = (count < space) ? count : space;
+
+    // copy in up to two pieces, to the end of the storage and then from
+    // the beginning. toEnd is up to 256, for a 256 byte buffer
+    const uint8_t index = tail & q->mask;
+    const uint16_t toEnd = (q->mask + 1) - index;
+    const uint8_t firstPiece = (numToPush < toEnd) ? numToPush : toEnd;
+    memcpy(&q->bytes[index], bytes, firstPiece);
+    memcpy(q->bytes, bytes + firstPiece, numToPush - firstPiece);
+
+    SPSCBYTEQUEUE_BARRIER();
+    q->tail = tail + numToPush;
+    if ((length + numToPush) > q->highwater) {
+        q->highwater = length + numToPush;
+    }
+    q->drops += count - numToPush;
+
+    return numToPush;
+}
+
+uint8_t SPSCByteQueue_popBlock (
+    ByteQueueElement *bytes,
+    const uint8_t maxCount,
+    SPSCByteQueue_t *q)
+{
+    const uint8_t head = q->head;
+    const uint8_t length = q->tail - head;
+    const uint8_t numToPop = (maxCount < length) ? maxCount : length;
+
+    const uint8_t index = head & q->mask;
+    const uint16_t toEnd = (q->mask + 1) - index;
+    const uint8_t firstPiece = (numToPop < toEnd) ? numToPop : toEnd;
+    memcpy(bytes, &q->bytes[index], firstPiece);
+    memcpy(bytes + firstPiece, q->bytes, numToPop - firstPiece);
+
+    SPSCBYTEQUEUE_BARRIER();
+    q->head = head + numToPop;
+
+    return numToPop;
+}
+
+uint16_t SPSCByteQueue_drops (
+   const SPSCByteQueue_t *q)
+{
+    // the count is 16 bits and the producer may be an ISR, so read it
+    // with interrupts off
+    char SREGSave;
+    SREGSave = SREG;
+    cli();
+    const uint16_t drops = q->drops;
+    SREG = SREGSave;
+
+    return drops;
+}
+
+void SPSCByteQueue_reportStatistics (
+   PGM_P queueName,
+   const SPSCByteQueue_t *q)
+{
+    CharString_define(32, msg);
+    CharString_copyP(queueName, &msg);
+    CharString_appendC(':', &msg);
+    StringUtils_appendDecimal(q->highwater, 1, 0, &msg);
+    CharString_appendC('/', &msg);
+    StringUtils_appendDecimal(SPSCByteQueue_capacity(q), 1, 0, &msg);
+    CharString_appendP(PSTR(" d:"), &msg);
+    StringUtils_appendDecimal32(SPSCByteQueue_drops(q), 1, 0, &msg);
+    Console_printCS(&msg);
+}
@@ -0,0 +1,204 @@
+//
+// Single-Producer Single-Consumer Byte Queue
+//
+//  What it does:
+//    A variant of ByteQueue for queues that have exactly one producer and
+//    one consumer (e.g. an ISR that receives bytes and a mainloop task that
+//    reads them). Unlike ByteQueue it never disables interrupts.
+//    The producer only writes the tail index and the consumer only writes
+//    the head index. The indices are 8 bits so that they are read and
+//    written atomically, and they run freely (wrapping at 256) so that
+//    the length is simply tail - head. The buffer size must be a power of
+//    2 no greater than 256, so that indices can be masked instead of
+//    compared and wrapped. The queue holds as many bytes as the buffer,
+//    except that a 256 byte buffer holds 255, since a length of 256 would
+//    look like 0.
+//
+//  How to use it:
+//    Define a queue like this:
+//       SPSCByteQueue_define(64, rxQueue, static)
+//    which defines static variable rxQueue with a capacity of 64 bytes.
+//    Call push (and is_full, spaceRemaining) only from the producer, and
+//    pop (and is_empty, head) only from the consumer. length can be called
+//    from either side; the result is a lower bound for the consumer and
+//    an upper bound for the producer.
+//    clear may only be called when neither side is active.
+//    pushBlock and popBlock move several bytes with a single index update.
+//    The consumer can also read bytes in place with peekSpan, which
+//    returns the contiguous run of bytes at the head of the queue, and
+//    then release them with commitSpan.
+//    Like ByteQueue, each queue keeps its high watermark and the number of
+//    bytes dropped because it was full. Both are written by the producer
+//    only.
+//
+
+#ifndef SPSCBYTEQUEUE_H
+#define SPSCBYTEQUEUE_H
+
+#include <stdbool.h>
+#include "inttypes.h"
+#include <avr/pgmspace.h>
+#include "ByteQueue.h"
+
+// keeps the compiler from moving memory accesses across this point, so
+// that a byte is stored before the tail index that publishes it, and read
+// before the head index that releases its slot
+#define SPSCBYTEQUEUE_BARRIER() __asm__ __volatile__ ("" ::: "memory")
+
+typedef struct {
+    volatile uint8_t head;  // written by consumer only
+    volatile uint8_t tail;  // written by producer only
+    uint8_t mask;           // buffer size - 1
+    uint8_t capacity;       // buffer size, or 255 for a 256 byte buffer
+    uint8_t highwater;      // written by producer only
+    uint16_t drops;         // written by producer only
+    ByteQueueElement *bytes;
+    } SPSCByteQueue_t;
+
+// fails to compile if size is not a power of 2 no greater than 256
+#define SPSCByteQueue_checkSize(size, queueName) \
+    typedef char queueName##_size_check[ \
+        ((((size) & ((size) - 1)) == 0) && ((size) <= 256)) ? 1 : -1];
+
+// size is the buffer size, which is also the capacity up to 128
+#define SPSCByteQueue_define(size, queueName, storage) \
+    SPSCByteQueue_checkSize(size, queueName) \
+    storage ByteQueueElement queueName##_buf[size] = {0}; \
+    storage SPSCByteQueue_t queueName = \
+        {0, 0, (size) - 1, ((size) < 256) ? (size) : 255, 0, 0, \
+         queueName##_buf};
+
+extern void SPSCByteQueue_clear (
+    SPSCByteQueue_t *q);
+
+inline uint8_t SPSCByteQueue_capacity (
+    const SPSCByteQueue_t *q)
+    {
+    return q->capacity;
+    }
+
+// returns the current length of the queue
+inline uint8_t SPSCByteQueue_length (
+    const SPSCByteQueue_t *q)
+    {
+    return (uint8_t)(q->tail - q->head);
+    }
+
+// returns the length available in the queue. producer only
+inline uint8_t SPSCByteQueue_spaceRemaining (
+    const SPSCByteQueue_t *q)
+    {
+    return q->capacity - (uint8_t)(q->tail - q->head);
+    }
+
+// returns true if the queue is currently empty. consumer only
+inline bool SPSCByteQueue_is_empty (
+   const SPSCByteQueue_t *q)
+   {
+    return q->tail == q->head;
+   }
+
+// returns true if the queue is currently full. producer only
+inline bool SPSCByteQueue_is_full (
+   const SPSCByteQueue_t *q)
+   {
+    return ((uint8_t)(q->tail - q->head)) >= q->capacity;
+   }
+
+// assumes the queue is not empty. consumer only
+inline ByteQueueElement SPSCByteQueue_head (
+   const SPSCByteQueue_t *q)
+{
+    return q->bytes[q->head & q->mask];
+}
+
+// pushes a byte onto the tail of the queue, if it's not full. returns
+// true if successful, otherwise counts the byte as dropped. producer only
+inline bool SPSCByteQueue_push (
+   const ByteQueueElement byte,
+   SPSCByteQueue_t *q)
+{
+    const uint8_t tail = q->tail;
+    const uint8_t length = tail - q->head;
+    if (length >= q->capacity) {
+        // full
+        ++q->drops;
+        return false;
+    }
+    q->bytes[tail & q->mask] = byte;
+    SPSCBYTEQUEUE_BARRIER();
+    q->tail = tail + 1;
+    if (length >= q->highwater) {
+        q->highwater = length + 1;
+    }
+    return true;
+}
+
+// pops a byte from the head of the queue, expects it's not empty.
+// consumer only
+inline ByteQueueElement SPSCByteQueue_pop (
+   SPSCByteQueue_t *q)
+{
+    const uint8_t head = q->head;
+    if (head == q->tail) {
+        // empty
+        return 0;
+    }
+    const ByteQueueElement byte = q->bytes[head & q->mask];
+    SPSCBYTEQUEUE_BARRIER();
+    q->head = head + 1;
+    return byte;
+}
+
+// pushes up to count bytes onto the tail of the queue. returns the number
+// of bytes pushed, which is less than count if the queue fills up (the
+// rest are counted as dropped). producer only
+extern uint8_t SPSCByteQueue_pushBlock (
+   const ByteQueueElement *bytes,
+   const uint8_t count,
+   SPSCByteQueue_t *q);
+
+// pops up to maxCount bytes from the head of the queue into bytes. returns
+// the number of bytes popped. consumer only
+extern uint8_t SPSCByteQueue_popBlock (
+   ByteQueueElement *bytes,
+   const uint8_t maxCount,
+   SPSCByteQueue_t *q);
+
+// sets span to the head of the queue and returns the number of bytes that
+// can be read there contiguously (up to the end of the storage, so it may
+// be less than the length of the queue). consumer only
+inline uint8_t SPSCByteQueue_peekSpan (
+   const SPSCByteQueue_t *q,
+   const ByteQueueElement **span)
+{
+    const uint8_t head = q->head;
+    const uint8_t length = q->tail - head;
+    const uint8_t index = head & q->mask;
+    // up to 256, for a 256 byte buffer
+    const uint16_t toEnd = (q->mask + 1) - index;
+    *span = &q->bytes[index];
+    return (length < toEnd) ? length : toEnd;
+}
+
+// removes count bytes, previously returned by peekSpan, from the head of
+// the queue. consumer only
+inline void SPSCByteQueue_commitSpan (
+   const uint8_t count,
+   SPSCByteQueue_t *q)
+{
+    SPSCBYTEQUEUE_BARRIER();
+    q->head = q->head + count;
+}
+
+// returns the number of bytes dropped because the queue was full. can be
+// called from either side
+extern uint16_t SPSCByteQueue_drops (
+   const SPSCByteQueue_t *q);
+
+// prints a line with the queue name, high watermark, capacity and drops
+extern void SPSCByteQueue_reportStatistics (
+   PGM_P queueName,
+   const SPSCByteQueue_t *q);
+
+#endif   // SPSCBYTEQUEUE_H
@@ -0,0 +1,97 @@
+//
+//  Sample History
+//
+//  Ring of timestamped samples taken between connections
+//
+#include "SampleHistory.h"
+
+#include "SystemTime.h"
+#include "PowerMonitor.h"
+#include "CellularComm_SIM800.h"
+#include "InternalTemperatureMonitor.h"
+
+#if SAMPLEHISTORY_ENABLED
+
+// state variables
+static SampleHistory_Sample samples[SAMPLEHISTORY_CAPACITY];
+static uint8_t head;
+static uint8_t length;
+static uint16_t overwrites;
+static uint32_t nextPeriodicSampleTime;   // uptime seconds
+
+void SampleHistory_Initialize (void)
+{
+    head = 0;
+    length = 0;
+    overwrites = 0;
+    nextPeriodicSampleTime = SAMPLEHISTORY_PERIODIC_INTERVAL;
+}
+
+void SampleHistory_takeSample (
+    const bool periodic)
+{
+    uint8_t tail = head + length;
+    if (tail >= SAMPLEHISTORY_CAPACITY) {
+        tail -= SAMPLEHISTORY_CAPACITY;
+    }
+    if (length == SAMPLEHISTORY_CAPACITY) {
+        // full. overwrite the oldest
+        if (++head == SAMPLEHISTORY_CAPACITY) {
+            head = 0;
+        }
+        ++overwrites;
+    } else {
+        ++length;
+    }
+
+    SampleHistory_Sample *sample = &samples[tail];
+    sample->uptime = SystemTime_uptime();
+    sample->batteryMillivolts = CellularComm_batteryMillivolts();
+    sample->temperature = InternalTemperatureMonitor_currentTemperature();
+    sample->flags =
+        (PowerMonitor_mainsOn() ? SAMPLEHISTORY_MAINS_ON : 0) |
+        (PowerMonitor_pumpOn() ? SAMPLEHISTORY_PUMP_ON : 0) |
+        (periodic ? SAMPLEHISTORY_PERIODIC : 0);
+}
+
+uint8_t SampleHistory_count (void)
+{
+    return length;
+}
+
+const SampleHistory_Sample* SampleHistory_sample (
+    const uint8_t index)
+{
+    uint8_t i = head + index;
+    if (i >= SAMPLEHISTORY_CAPACITY) {
+        i -= SAMPLEHISTORY_CAPACITY;
+    }
+    return &samples[i];
+}
+
+void SampleHistory_discard (
+    const uint8_t count)
+{
+    const uint8_t toDiscard = (count > length) ? length : count;
+    head += toDiscard;
+    if (head >= SAMPLEHISTORY_CAPACITY) {
+        head -= SAMPLEHISTORY_CAPACITY;
+    }
+    length -= toDiscard;
+}
+
+uint16_t SampleHistory_overwrites (void)
+{
+    return overwrites;
+}
+
+void SampleHistory_task (void)
+{
+    const uint32_t uptime = SystemTime_uptime();
+    if (uptime >= nextPeriodicSampleTime) {
+        nextPeriodicSampleTime = uptime + SAMPLEHISTORY_PERIODIC_INTERVAL;
+        SampleHistory_takeSample(true);
+    }
+}
+
+#endif  // SAMPLEHISTORY_ENABLED
@@ -0,0 +1,68 @@
+//
+//  Sample History
+//
+//  Ring of timestamped samples taken between connections, so mains and
+//  pump changes that happen between logging intervals are not lost.
+//  A sample is taken on every mains or pump change and periodically.
+//  The ring is in RAM only, so samples not yet sent are lost on a reboot.
+//
+//  How to use it:
+//      Call SampleHistory_takeSample from the PowerMonitor notification.
+//      When connected, send SampleHistory_count() samples (oldest is
+//      index 0), and call SampleHistory_discard with that count once
+//      they have been delivered. When the ring is full the oldest
+//      sample is overwritten.
+//
+#ifndef SAMPLEHISTORY_H
+#define SAMPLEHISTORY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// the history is only sent to hosts that ask for it with "history on".
+// when 0 the module is left out so that its ring doesn't take up RAM, and
+// WaterLevelDisplay sends only the current sample
+#ifndef SAMPLEHISTORY_ENABLED
+#define SAMPLEHISTORY_ENABLED 0
+#endif
+
+#define SAMPLEHISTORY_CAPACITY 16
+
+// seconds between periodic samples
+#define SAMPLEHISTORY_PERIODIC_INTERVAL 900
+
+// SampleHistory_Sample flags
+#define SAMPLEHISTORY_MAINS_ON  0x01
+#define SAMPLEHISTORY_PUMP_ON   0x02
+#define SAMPLEHISTORY_PERIODIC  0x80
+
+typedef struct SampleHistory_Sample_struct {
+    uint32_t uptime;            // seconds since power-up when taken
+    uint16_t batteryMillivolts;
+    int16_t temperature;        // degrees C
+    uint8_t flags;
+} SampleHistory_Sample;
+
+extern void SampleHistory_Initialize (void);
+
+// takes a sample now. periodic is false for mains and pump changes
+extern void SampleHistory_takeSample (
+    const bool periodic);
+
+extern uint8_t SampleHistory_count (void);
+
+// oldest sample is index 0
+extern const SampleHistory_Sample* SampleHistory_sample (
+    const uint8_t index);
+
+// removes the given number of oldest samples
+extern void SampleHistory_discard (
+    const uint8_t count);
+
+// number of samples overwritten before they could be sent
+extern uint16_t SampleHistory_overwrites (void);
+
+// takes periodic samples
+extern void SampleHistory_task (void);
+
+#endif  // SAMPLEHISTORY_H
@@ -11,6 +11,10 @@
 //    data input pin. When the interrupt fires a timer is used to clock
 //    a state machine to read each bit and push the resulting byte into
 //    the queue.
+//    The timer runs at three times the baud rate, starting 1/6 bit after
+//    the falling edge of the start bit, so each bit is sampled at 1/6, 1/2
+//    and 5/6 of its width and takes the majority value. This tolerates a
+//    glitch or an edge that lands near a sample point.
 //
 
 #include "SoftwareSerialRx0.h"
@@ -18,6 +22,9 @@
 #include <avr/io.h>
 #include <avr/interrupt.h>
 #include <stdlib.h>
+#include "CharString.h"
+#include "Console.h"
+#include "StringUtils.h"
 
 #define SERIAL_RX_DDR      DDRB
 #define SERIAL_RX_PORT     PORTB
@@ -27,8 +34,20 @@
 #define SERIAL_RX_PCINT    PCINT4
 #define SERIAL_RX_PCIE     PCIE0
 
-// with 8 prescale this 1/4800 second
-#define BIT_CLOCK_TIME ((F_CPU / 8) / 4800)
+#define SAMPLES_PER_BIT 3
+#define SAMPLE_RATE (SOFTWARESERIALRX0_BAUD_RATE * SAMPLES_PER_BIT)
+
+// timer0 runs unprescaled if the sample period fits in 8 bits (19200 baud
+// and up), otherwise prescaled by 8. the period is rounded to nearest
+#if ((F_CPU + (SAMPLE_RATE / 2)) / SAMPLE_RATE) <= 256
+#define TIMER0_PRESCALE 1
+#define TIMER0_CLOCK_SELECT 1
+#else
+#define TIMER0_PRESCALE 8
+#define TIMER0_CLOCK_SELECT 2
+#endif
+#define SAMPLE_CLOCK_TIME \
+    ((((F_CPU / TIMER0_PRESCALE) + (SAMPLE_RATE / 2)) / SAMPLE_RATE) - 1)
 
 typedef enum RxState_enum {
     rs_idle,
@@ -41,7 +60,10 @@ static volatile bool isEnabled;
 static volatile RxState rxState;
 static ByteQueueElement dataByte;
 static uint8_t bitMask;
-ByteQueue_define(16, rxQueue, static);
+static uint8_t sampleCount;
+static uint8_t onesCount;
+static volatile uint16_t framingErrors;
+SPSCByteQueue_define(64, rxQueue, static);
 
 static bool rxBit (void)
 {
@@ -50,16 +72,17 @@ static bool rxBit (void)
 
 void SoftwareSerialRx0_Initialize (void)
 {
-    ByteQueue_clear(&rxQueue);
+    SPSCByteQueue_clear(&rxQueue);
+    framingErrors = 0;
 
     // make rx pin an input and enable pullup
     SERIAL_RX_DDR &= (~(1 << SERIAL_RX_PIN));
     SERIAL_RX_PORT |= (1 << SERIAL_RX_PIN);
 
-    // set up timer2 to fire interrupt 4800 Hz (baud clock)
+    // set up timer0 to fire interrupt at SAMPLE_RATE
     TCCR0A = 2; // set CTC mode (WGM01:00)
-    TCCR0B = 2; // set CTC mode (WGM02), CS = prescale by 8
-    OCR0A = BIT_CLOCK_TIME;
+    TCCR0B = TIMER0_CLOCK_SELECT;   // CTC mode (WGM02 = 0), prescale
+    OCR0A = SAMPLE_CLOCK_TIME;
     TCNT0 = 0;  // start the time counter at 0
     TIFR0 |= (1 << OCF0A);  // "clear" the timer compare flag
 
@@ -89,19 +112,40 @@ void SoftwareSerialRx0_disable (void)
     }
 }
 
-ByteQueue_t* SoftwareSerial_rx0Queue (void)
+SPSCByteQueue_t* SoftwareSerial_rx0Queue (void)
 {
     return &rxQueue;
 }
 
+uint16_t SoftwareSerialRx0_framingErrors (void)
+{
+    uint16_t errors;
+
+    char SREGSave;
+    SREGSave = SREG;
+    cli();
+    errors = framingErrors;
+    SREG = SREGSave;
+
+    return errors;
+}
+
+uint16_t SoftwareSerialRx0_overruns (void)
+{
+    return SPSCByteQueue_drops(&rxQueue);
+}
+
 ISR(PCINT0_vect, ISR_BLOCK)
 {
     if (!rxBit()) {
         TIFR0 |= (1 << OCF0A);  // "clear" the timer compare flag
         TIMSK0 |= (1 << OCIE0A);// enable timer compare match interrupt
         TCNT0 = 0;  // start the time counter at 0
-        // set timer for 1/2 bit time to get in the middle of the start bit
-        OCR0A = BIT_CLOCK_TIME / 2;
+        // set timer for 1/2 sample time to get to the first sample point
+        // of the start bit
+        OCR0A = SAMPLE_CLOCK_TIME / 2;
+        sampleCount = 0;
+        onesCount = 0;
 
         // disable this interrupt
         SERIAL_RX_PCMSK &= ~(1 << SERIAL_RX_PCINT);
@@ -111,13 +155,24 @@ ISR(PCINT0_vect, ISR_BLOCK)
 
 ISR(TIMER0_COMPA_vect, ISR_BLOCK)
 {
+    OCR0A = SAMPLE_CLOCK_TIME;
+    if (rxBit()) {
+        ++onesCount;
+    }
+    if (++sampleCount < SAMPLES_PER_BIT) {
+        return;
+    }
+    // majority vote of the samples of this bit
+    const bool bitValue = onesCount > (SAMPLES_PER_BIT / 2);
+    sampleCount = 0;
+    onesCount = 0;
+
     switch (rxState) {
         case rs_waitingForStartBit :
-            if (!rxBit()) {
+            if (!bitValue) {
                 // rx bit is low - got start bit
                 dataByte = 0;
                 bitMask = 1;
-                OCR0A = BIT_CLOCK_TIME;
                 rxState = rs_readingDataBits;
             } else {
                 // expected low for start bit but didn't get it
@@ -127,7 +182,7 @@ ISR(TIMER0_COMPA_vect, ISR_BLOCK)
             }
             break;
         case rs_readingDataBits :
-            if (rxBit()) {
+            if (bitValue) {
                 dataByte |= bitMask;
             }
             if (bitMask == 0x80) {
@@ -137,9 +192,12 @@ ISR(TIMER0_COMPA_vect, ISR_BLOCK)
             }
             break;
         case rs_waitingForStopBit :
-            if (rxBit()) {
-                // got stop bit.
-                ByteQueue_push(dataByte, &rxQueue);
+            if (bitValue) {
+                // got stop bit. if the queue is full the byte is
+                // counted in its drops
+                SPSCByteQueue_push(dataByte, &rxQueue);
+            } else {
+                ++framingErrors;
             }
             TIMSK0 &= ~(1 << OCIE0A);// disable timer compare match interrupt
             rxState = rs_idle;
@@ -152,9 +210,15 @@ ISR(TIMER0_COMPA_vect, ISR_BLOCK)
     }
 }
 
-#if BYTEQUEUE_HIGHWATERMARK_ENABLED
-void SoftwareSerialRx0_reportHighwater (void)
+void SoftwareSerialRx0_reportQueue (
+    const uint8_t line)
 {
-    ByteQueue_reportHighwater(PSTR("SSRX0"), &rxQueue);
+    if (line == 0) {
+        SPSCByteQueue_reportStatistics(PSTR("SSRX0"), &rxQueue);
+    } else {
+        CharString_define(20, msg);
+        CharString_copyP(PSTR("SSRX0 fe:"), &msg);
+        StringUtils_appendDecimal32(SoftwareSerialRx0_framingErrors(), 1, 0, &msg);
+        Console_printCS(&msg);
+    }
 }
-#endif
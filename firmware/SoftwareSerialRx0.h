@@ -3,8 +3,10 @@
 //
 //  What it does:
 //      Software implementation of UART Receiver
-//      Currently hardcoded to listen for 8N1 on pin PC2 at 4800 baud
-//      Has an 80-byte queue.
+//      Listens for 8N1 on pin PB4 at SOFTWARESERIALRX0_BAUD_RATE, sampling
+//      each bit three times and taking the majority value.
+//      Has a 64-byte queue. Counts framing errors (stop bit low) and
+//      overruns (byte received while the queue is full, which drops it).
 //
 //  How to use it:
 //     Call SoftwareSerialRx0_Initialize() once at the beginning of the
@@ -14,7 +16,7 @@
 //
 //  Hardware resources used:
 //    Serial data in - PB4
-//    AtMega328P 8-bit Timer 0
+//    AtMega32u4 8-bit Timer 0
 //
 #ifndef SOFTWARESERIALRX0_H
 #define SOFTWARESERIALRX0_H
@@ -23,7 +25,16 @@
 #include <stdbool.h>
 #include <string.h>
 #include <stddef.h>
-#include "ByteQueue.h"
+#include "SPSCByteQueue.h"
+#include "SystemTime.h"
+
+// SoftwareSerialTx sends one bit per SystemTime tick, so the SIM800 link
+// runs at SYSTEMTIME_TICKS_PER_SECOND (4800) both ways. the receiver's
+// timer setup would handle other rates, but the transmitter can't follow
+#define SOFTWARESERIALRX0_BAUD_RATE SYSTEMTIME_TICKS_PER_SECOND
+#if SOFTWARESERIALRX0_BAUD_RATE != SYSTEMTIME_TICKS_PER_SECOND
+#error "SoftwareSerialRx0 must receive at the SoftwareSerialTx (SystemTime tick) rate"
+#endif
 
 // comes up enabled by default
 extern void SoftwareSerialRx0_Initialize (void);
@@ -31,11 +42,18 @@ extern void SoftwareSerialRx0_Initialize (void);
 extern void SoftwareSerialRx0_enable (void);
 extern void SoftwareSerialRx0_disable (void);
 
-extern ByteQueue_t* SoftwareSerial_rx0Queue (void);
+extern SPSCByteQueue_t* SoftwareSerial_rx0Queue (void);
 
-#if BYTEQUEUE_HIGHWATERMARK_ENABLED
-extern void SoftwareSerialRx0_reportHighwater (void);
-#endif
+// number of bytes dropped because the stop bit was not high since
+// SoftwareSerialRx0_Initialize, and because the queue was full since
+// powerup
+extern uint16_t SoftwareSerialRx0_framingErrors (void);
+extern uint16_t SoftwareSerialRx0_overruns (void);
+
+// prints the rx queue statistics (line 0) or the framing error count
+// (line 1)
+extern void SoftwareSerialRx0_reportQueue (
+    const uint8_t line);
 
 #endif  /* SOFTWARESERIALRX0_H */
 
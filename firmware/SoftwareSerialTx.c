@@ -10,7 +10,7 @@
 #include "SoftwareSerialTx.h"
 
 #include <avr/io.h>
-#include "ByteQueue.h"
+#include "SPSCByteQueue.h"
 #include "SystemTime.h"
 
 #include "UART_async.h"
@@ -29,12 +29,14 @@ typedef struct TxDescriptor_struct {
     volatile ByteQueueElement dataByte;
     volatile uint8_t bitNumber;
     IOPortBitfield_t txBit;
-    ByteQueue_t *txQueue;
+    SPSCByteQueue_t *txQueue;
 } TxDescriptor;
 static TxDescriptor channels[NUM_CHANNELS];
 
-ByteQueue_define(100, txQueue0, static);
-ByteQueue_define(100, txQueue1, static);
+// channel 0 carries the SIM800 commands and data. channel 1 is not
+// currently used
+SPSCByteQueue_define(128, txQueue0, static);
+SPSCByteQueue_define(16, txQueue1, static);
 
 static void setTxBit (
     const uint8_t bit,
@@ -54,10 +56,10 @@ static void systemTimeTickTask (void)
         if (channel->isEnabled) {
             switch (channel->txState) {
                 case ts_idle:
-                    if (!ByteQueue_is_empty(channel->txQueue)) {
+                    if (!SPSCByteQueue_is_empty(channel->txQueue)) {
                         // issue start bit
                         setTxBit(0, &channel->txBit);
-                        channel->dataByte = ByteQueue_pop(channel->txQueue);
+                        channel->dataByte = SPSCByteQueue_pop(channel->txQueue);
                         channel->bitNumber = 1;
                         channel->txState = ts_sendingDataBits;
                     }
@@ -105,7 +107,7 @@ void SoftwareSerialTx_open (
     IOPortBitfield_set(txBit);
 
     channel->isEnabled = false;
-    ByteQueue_clear(channel->txQueue);
+    SPSCByteQueue_clear(channel->txQueue);
 }
 
 void SoftwareSerialTx_enable (
@@ -126,14 +128,14 @@ bool SoftwareSerialTx_isIdle (
     const uint8_t channelIndex)
 {
     TxDescriptor *channel = &channels[channelIndex];
-    return ((channel->txState == ts_idle) && ByteQueue_is_empty(channel->txQueue));
+    return ((channel->txState == ts_idle) && SPSCByteQueue_is_empty(channel->txQueue));
 }
 
 uint16_t SoftwareSerialTx_availableSpace (
     const uint8_t channelIndex)
 {
-    ByteQueue_t *txQueue = channels[channelIndex].txQueue;
-    return txQueue->capacity - txQueue->length;
+    SPSCByteQueue_t *txQueue = channels[channelIndex].txQueue;
+    return SPSCByteQueue_spaceRemaining(txQueue);
 }
 
 void SoftwareSerialTx_send (
@@ -142,12 +144,9 @@ void SoftwareSerialTx_send (
 {
     TxDescriptor *channel = &channels[channelIndex];
     if (channel->isEnabled) {
-        ByteQueue_t *txQueue = channel->txQueue;
-        const char* cp = text;
-        char ch;
-        while ((ch = *cp++) != 0) {
-            ByteQueue_push((ByteQueueElement)ch, txQueue);
-        }
+        const size_t length = strlen(text);
+        SPSCByteQueue_pushBlock((const ByteQueueElement*)text,
+            (length > 255) ? 255 : length, channel->txQueue);
     }
 }
 
@@ -166,13 +165,9 @@ void SoftwareSerialTx_sendCSS (
 {
     TxDescriptor *channel = &channels[channelIndex];
     if (channel->isEnabled) {
-        ByteQueue_t *txQueue = channel->txQueue;
-        CharString_Iter iter = CharStringSpan_begin(text);
-        CharString_Iter end = CharStringSpan_end(text);
-        while (iter != end) {
-            const char ch = *iter++;
-            ByteQueue_push((ByteQueueElement)ch, txQueue);
-        }
+        SPSCByteQueue_pushBlock(
+            (const ByteQueueElement*)CharStringSpan_begin(text),
+            CharStringSpan_length(text), channel->txQueue);
     }
 }
 
@@ -184,9 +179,9 @@ bool SoftwareSerialTx_sendP (
 
     TxDescriptor *channel = &channels[channelIndex];
     if (channel->isEnabled) {
-        ByteQueue_t *txQueue = channel->txQueue;
+        SPSCByteQueue_t *txQueue = channel->txQueue;
         // check if there is enough space left in the tx queue
-        if (strlen_P(string) <= ByteQueue_spaceRemaining(txQueue))
+        if (strlen_P(string) <= SPSCByteQueue_spaceRemaining(txQueue))
             {  // there is enough space in the queue
             // push all bytes onto the queue
             PGM_P cp = string;
@@ -195,7 +190,7 @@ bool SoftwareSerialTx_sendP (
                 ch = pgm_read_byte(cp);
                 ++cp;
                 if (ch != 0) {
-                    ByteQueue_push(ch, txQueue);
+                    SPSCByteQueue_push(ch, txQueue);
                 }
             } while (ch != 0);
 
@@ -212,14 +207,14 @@ void SoftwareSerialTx_sendChar (
 {
     TxDescriptor *channel = &channels[channelIndex];
     if (channel->isEnabled) {
-        ByteQueue_push((ByteQueueElement)ch, channel->txQueue);
+        SPSCByteQueue_push((ByteQueueElement)ch, channel->txQueue);
     }
 }
 
-#if BYTEQUEUE_HIGHWATERMARK_ENABLED
-void SoftwareSerialTx_reportHighwater (void)
+void SoftwareSerialTx_reportQueue (
+    const uint8_t channelIndex)
 {
-    ByteQueue_reportHighwater(PSTR("SSTX0"), channels[0].txQueue);
-    ByteQueue_reportHighwater(PSTR("SSTX1"), channels[1].txQueue);
+    SPSCByteQueue_reportStatistics(
+        (channelIndex == 0) ? PSTR("SSTX0") : PSTR("SSTX1"),
+        channels[channelIndex].txQueue);
 }
-#endif
@@ -15,7 +15,7 @@
 #include <avr/pgmspace.h>
 #include "CharStringSpan.h"
 #include "IOPortBitfield.h"
-#include "ByteQueue.h"
+#include "SPSCByteQueue.h"
 
 extern void SoftwareSerialTx_Initialize (void);
 
@@ -55,9 +55,9 @@ extern void SoftwareSerialTx_sendChar (
     const uint8_t channelIndex,
     const char ch);
 
-#if BYTEQUEUE_HIGHWATERMARK_ENABLED
-extern void SoftwareSerialTx_reportHighwater (void);
-#endif
+// prints the statistics of the given channel's transmit queue
+extern void SoftwareSerialTx_reportQueue (
+    const uint8_t channelIndex);
 
 #endif  /* SOFTWARESERIALTX_H */
 
@@ -312,3 +312,65 @@ int StringUtils_lookupString (
 
     return middle;
 }
+
+// returns the character at position of table entry index
+static char tableEntryChar (
+    PGM_P table[],
+    const uint8_t index,
+    const uint8_t position)
+{
+    PGM_P tableEntry = (PGM_P)pgm_read_word(&(table[index]));
+    return pgm_read_byte(tableEntry + position);
+}
+
+void StringUtils_beginLookup (
+    const int tableSize,
+    StringUtils_Lookup_t *lookup)
+{
+    lookup->first = 0;
+    lookup->last = tableSize;
+    lookup->length = 0;
+}
+
+void StringUtils_lookupChar (
+    const char ch,
+    PGM_P table[],
+    StringUtils_Lookup_t *lookup)
+{
+    uint8_t first = lookup->first;
+    uint8_t last = lookup->last;
+    if ((ch == 0) || (lookup->length == 255)) {
+        // can't match any entry
+        first = last;
+    } else {
+        // the candidates share their first length characters, so they are
+        // sorted by the character at length. entries that end there have a
+        // null, which sorts first
+        const uint8_t position = lookup->length;
+        while ((first < last) &&
+               (tableEntryChar(table, first, position) < ch)) {
+            ++first;
+        }
+        while ((first < last) &&
+               (tableEntryChar(table, last - 1, position) > ch)) {
+            --last;
+        }
+    }
+    if (lookup->length < 255) {
+        ++lookup->length;
+    }
+    lookup->first = first;
+    lookup->last = last;
+}
+
+int StringUtils_lookupResult (
+    PGM_P table[],
+    const int tableSize,
+    const StringUtils_Lookup_t *lookup)
+{
+    // an exact match is the shortest candidate, which is the first
+    return ((lookup->first < lookup->last) &&
+            (tableEntryChar(table, lookup->first, lookup->length) == 0))
+        ? lookup->first
+        : tableSize;
+}
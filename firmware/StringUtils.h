@@ -78,4 +78,34 @@ extern int StringUtils_lookupString (
     PGM_P table[],
     const int tableSize);
 
+// incremental version of StringUtils_lookupString, for strings that arrive
+// one character at a time. the sorted table is walked as an implicit trie:
+// the candidates are the range of entries that start with the characters
+// seen so far, and each character only narrows that range, so no
+// character is compared more than once per entry. usage:
+//    StringUtils_beginLookup(tableSize, &lookup);
+//    StringUtils_lookupChar(c, table, &lookup);  // for each character
+//    index = StringUtils_lookupResult(table, tableSize, &lookup);
+typedef struct StringUtils_Lookup_struct {
+    uint8_t first;      // first candidate entry
+    uint8_t last;       // one past the last candidate entry
+    uint8_t length;     // number of characters seen
+} StringUtils_Lookup_t;
+
+extern void StringUtils_beginLookup (
+    const int tableSize,
+    StringUtils_Lookup_t *lookup);
+
+extern void StringUtils_lookupChar (
+    const char ch,
+    PGM_P table[],
+    StringUtils_Lookup_t *lookup);
+
+// returns index of match (0..tableSize-1), or tableSize if the characters
+// seen so far are not an entry of the table
+extern int StringUtils_lookupResult (
+    PGM_P table[],
+    const int tableSize,
+    const StringUtils_Lookup_t *lookup);
+
 #endif  // StringUtils_H
\ No newline at end of file
@@ -18,7 +18,12 @@
 #define DEBUG_TRACE 1
 #define MAX_TICK_NOTIFICATION_FUNCTIONS 2
 
+// timer3 compare value. timer3 counts from 0 to TIMER3_TOP, so a tick is
+// TIMER3_TOP + 1 counts
+#define TIMER3_TOP ((F_CPU / 8) / SYSTEMTIME_TICKS_PER_SECOND)
+
 static volatile uint16_t tickCounter = 0;
+static volatile uint16_t freeRunningTicks = 0;
 static volatile SystemTime_t currentTime;
 static volatile uint32_t secondsSinceStartup;
 static int32_t timeAdjustment;
@@ -54,7 +59,7 @@ void SystemTime_Initialize (void)
     // set up timer3 to fire interrupt at SYSTEMTIME_TICKS_PER_SECOND
     TCCR3B = (TCCR3B & 0xF8) | 2; // prescale by 8
     TCCR3B = (TCCR3B & 0xE7) | (1 << 3); // set CTC mode
-    OCR3A = (F_CPU / 8) / SYSTEMTIME_TICKS_PER_SECOND;
+    OCR3A = TIMER3_TOP;
     TCNT3 = 0;  // start the time counter at 0
     TIFR3 |= (1 << OCF3A);  // "clear" the timer compare flag
     TIMSK3 |= (1 << OCIE3A);// enable timer compare match interrupt
@@ -81,6 +86,42 @@ void SystemTime_getCurrentTime (
     SREG = SREGSave;
 }
 
+uint16_t SystemTime_ticks (void)
+{
+    uint16_t ticks;
+
+    char SREGSave;
+    SREGSave = SREG;
+    cli();
+    ticks = freeRunningTicks;
+    SREG = SREGSave;
+
+    return ticks;
+}
+
+uint16_t SystemTime_timerCounts (void)
+{
+    uint16_t ticks;
+    uint16_t counts;
+
+    char SREGSave;
+    SREGSave = SREG;
+    cli();
+    counts = TCNT3;
+    ticks = freeRunningTicks;
+    if ((TIFR3 & (1 << OCF3A)) != 0) {
+        // compare match occurred but the interrupt hasn't been serviced
+        // yet, so the counter has restarted
+        ++ticks;
+        counts = TCNT3;
+    }
+    SREG = SREGSave;
+
+    // arithmetic is modulo 2^16 in both ticks and the result, so the
+    // timestamp wraps consistently
+    return (ticks * (TIMER3_TOP + 1)) + counts;
+}
+
 uint32_t SystemTime_uptime (void)
 {
     uint32_t uptime;
@@ -319,6 +360,7 @@ void SystemTime_appendToString (
 ISR(TIMER3_COMPA_vect, ISR_BLOCK)
 {
     ++tickCounter;
+    ++freeRunningTicks;
     if (taskTickCounter < 255) ++taskTickCounter;
     if (tickCounter >= (SYSTEMTIME_TICKS_PER_SECOND / 100)) {
         tickCounter = 0;
@@ -44,6 +44,14 @@ extern void SystemTime_getCurrentTime (
     SystemTime_t *curTime);
 
 extern uint32_t SystemTime_uptime (void);
+
+// free-running count of ticks (SYSTEMTIME_TICKS_PER_SECOND). wraps around
+// every 13.6 seconds, so compare tick counts by subtraction
+extern uint16_t SystemTime_ticks (void);
+
+// returns a timestamp in Timer3 counts (microseconds at 8MHz). wraps around
+// every 65.5 milliseconds, so compare timestamps by subtraction
+extern uint16_t SystemTime_timerCounts (void);
 extern SystemTime_LastRebootBy SystemTime_LastReboot (void);
 
 // initializes futureTime to the current time plus
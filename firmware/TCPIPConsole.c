@@ -24,6 +24,7 @@ typedef enum SendingState_enum {
 static bool isEnabled;
 static SIM800_IPDataCallback dataReceiver;
 static CellularTCPIP_DataProvider sendDataProvider;
+static uint16_t sendDataLength;
 static CellularTCPIP_SendCompletionCallback sendCompletionCallback;
 static SendingState sState;
 static SystemTime_t nextConnectAttemptTime;
@@ -72,7 +73,7 @@ void TCPIPConsole_task (void)
                 case cs_connected :
                     if (isEnabled) {
                         if (sendDataProvider != 0) {
-                            CellularTCPIP_sendData(sendDataProvider, sendCompletionCallback);
+                            CellularTCPIP_sendData(sendDataProvider, sendDataLength, sendCompletionCallback);
                             sState = ss_waitingForTCPIPSendingData;
                         }
                     } else {
@@ -179,9 +180,11 @@ bool TCPIPConsole_readyToSend (void)
 
 void TCPIPConsole_sendData (
     CellularTCPIP_DataProvider dataProvider,
+    const uint16_t dataLength,
     CellularTCPIP_SendCompletionCallback completionCallback)
 {
     sendDataProvider = dataProvider;
+    sendDataLength = dataLength;
     sendCompletionCallback = completionCallback;
 }
 
@@ -30,8 +30,10 @@ extern void TCPIPConsole_setDataReceiver (
 
 extern bool TCPIPConsole_readyToSend (void);
 
+// see CellularTCPIP_sendData for dataLength
 extern void TCPIPConsole_sendData (
     CellularTCPIP_DataProvider dataProvider,
+    const uint16_t dataLength,
     CellularTCPIP_SendCompletionCallback completionCallback);
 
 #endif  /* TCPIPCONSOLE_H */
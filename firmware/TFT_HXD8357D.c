@@ -118,8 +118,6 @@ static TFTState tftState;
 static SystemTime_t time;
 
 static TFT_HXD8357D_RectangleSource rectangleSource;
-static uint32_t currentRectRemainingPixels;
-static uint16_t currentRectColor;
 
 static TFT_HXD8357D_TextSource textSource;
 static uint16_t currentCharX;
@@ -129,6 +127,8 @@ static CharString_Iter currentTextEndIter;
 static const GFXfont *currentFont;
 static uint16_t currentTextFGColor;
 static uint16_t currentTextBGColor;
+static uint16_t textRunColor;
+static uint16_t textRunLength;
 
 static volatile uint8_t backlightPWMCount;
 static uint8_t backlightBrightness; // 0 - 10, 0 is off, 10 is full on
@@ -212,16 +212,9 @@ static void spiWrite16 (
     const uint16_t word,
     const uint16_t repeat)
 {
-    const uint8_t hi = word >> 8;
-    const uint8_t lo = word & 0xFF;
-    uint16_t remaining = repeat;
-    while (remaining-- > 0) {
-        while (!SPIAsync_operationCompleted());
-        SPIAsync_sendByte(hi);
-        while (!SPIAsync_operationCompleted());
-        SPIAsync_sendByte(lo);
-    }
     while (!SPIAsync_operationCompleted());
+    SPIAsync_beginRepeat16(word, repeat);
+    SPIAsync_continueRepeat16(repeat);
 }
 
 static void spiWriteP (
@@ -305,21 +298,13 @@ static void beginRectangle (
     writeCommand(HX8357_RAMWR); // write to RAM
 
     // write pixels
-    currentRectColor = rect->color;
-    currentRectRemainingPixels = ((uint32_t)rect->width) * rect->height;
+    SPIAsync_beginRepeat16(rect->color, ((uint32_t)rect->width) * rect->height);
 }
 
 // returns true if it needs to continue drawing the rectangle
 static bool continueRectangle (void)
 {
-    const uint16_t pixelsToWrite = 
-        (currentRectRemainingPixels > MAX_PIXELS_PER_BURST)
-        ? MAX_PIXELS_PER_BURST
-        : currentRectRemainingPixels;
-    spiWrite16(currentRectColor, pixelsToWrite);
-
-    currentRectRemainingPixels -= pixelsToWrite;
-    if (currentRectRemainingPixels == 0) {
+    if (!SPIAsync_continueRepeat16(MAX_PIXELS_PER_BURST)) {
         // all pixels have been written
         SPIAsync_deassertSS();
         return false;
@@ -342,6 +327,23 @@ static void beginText (
     currentTextBGColor = t->bgColor;
 }
 
+// adds count pixels of the given color to the current text run, sending
+// the current run first if it is a different color
+static void appendTextRun (
+    const uint16_t color,
+    const uint16_t count)
+{
+    if (count == 0) {
+        return;
+    }
+    if (color != textRunColor) {
+        spiWrite16(textRunColor, textRunLength);
+        textRunColor = color;
+        textRunLength = 0;
+    }
+    textRunLength += count;
+}
+
 static bool continueText (void)
 {
     const uint8_t c = (*currentTextIter) - (uint8_t)pgm_read_byte(&currentFont->first);
@@ -371,42 +373,51 @@ static bool continueText (void)
 
     writeCommand(HX8357_RAMWR); // write to RAM
 
-    // write blank space above glyph, if any
+    // send the glyph cell as runs of a single color. adjacent pixels of
+    // the same color, including the blank space around the glyph and
+    // across rows, are merged so that each run is one repeated write
+    textRunColor = currentTextBGColor;
+    textRunLength = 0;
+
+    // blank space above glyph, if any
     const uint16_t spaceAbove = gyo - yTop;
-    if (spaceAbove > 0) {
-        spiWrite16(currentTextBGColor, spaceAbove * w);
-    }
+    appendTextRun(currentTextBGColor, spaceAbove * w);
 
-    for(int yy=0; yy<gh; yy++) {
-        // write blank space to the left of the glyph, if any
+    for (uint8_t yy = 0; yy < gh; yy++) {
+        // blank space to the left of the glyph, if any
         if (gxo > 0) {
-            spiWrite16(currentTextBGColor, gxo);
+            appendTextRun(currentTextBGColor, gxo);
         }
 
-        // write a row of the glyph
-        for(int xx=0; xx<gw; xx++) {
-            if(!(bit++ & 7)) {
+        // a row of the glyph
+        for (uint8_t xx = 0; xx < gw; xx++) {
+            if (!(bit++ & 7)) {
                 bits = pgm_read_byte(&bitmap[bo++]);
             }
 
-            spiWrite16(((bits & 0x80) != 0)
-                       ? currentTextFGColor
-                       : currentTextBGColor, 1);
+            const uint16_t color = ((bits & 0x80) != 0)
+                ? currentTextFGColor
+                : currentTextBGColor;
+            if (color != textRunColor) {
+                spiWrite16(textRunColor, textRunLength);
+                textRunColor = color;
+                textRunLength = 0;
+            }
+            ++textRunLength;
             bits <<= 1;
         }
 
-        // write blank space to the left of the glyph, if any
+        // blank space to the right of the glyph, if any
         const uint8_t spaceRight = w - (gxo + gw);
-        if (spaceRight > 0) {
-            spiWrite16(currentTextBGColor, spaceRight);
-        }
+        appendTextRun(currentTextBGColor, spaceRight);
     }
 
-    // write blank space below glyph, if any
+    // blank space below glyph, if any
     const uint16_t spaceBelow = yBottom - (gyo + gh);
-    if (spaceBelow > 0) {
-        spiWrite16(currentTextBGColor, spaceBelow * w);
-    }
+    appendTextRun(currentTextBGColor, spaceBelow * w);
+
+    // last run
+    spiWrite16(textRunColor, textRunLength);
 
     currentCharX += w;
     ++currentTextIter;
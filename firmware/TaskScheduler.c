@@ -0,0 +1,150 @@
+//
+//  Task Scheduler
+//
+
+#include "TaskScheduler.h"
+
+#include "SystemTime.h"
+#if TASKSCHEDULER_PROFILING_ENABLED
+#include "Console.h"
+#include "CharString.h"
+#include "StringUtils.h"
+
+// time between report lines, in system ticks
+#define REPORT_LINE_INTERVAL (SYSTEMTIME_TICKS_PER_SECOND / 100)
+#endif
+
+typedef struct TaskState_struct {
+    uint16_t nextDueTicks;
+#if TASKSCHEDULER_PROFILING_ENABLED
+    uint16_t runCount;
+    uint16_t maxCounts;
+    uint32_t totalCounts;
+#endif
+} TaskState;
+
+static const TaskScheduler_TaskDesc *taskTable;
+static uint8_t numTableTasks;
+static TaskState taskStates[TASKSCHEDULER_MAX_TASKS];
+static uint16_t nextDelayTicks; // time until the running task is next due
+#if TASKSCHEDULER_PROFILING_ENABLED
+static uint8_t reportIndex;    // next task to report, or numTableTasks if none
+static uint16_t nextReportTicks;
+#endif
+
+void TaskScheduler_Initialize (
+    const TaskScheduler_TaskDesc *tasks,
+    const uint8_t numTasks)
+{
+    taskTable = tasks;
+    numTableTasks = (numTasks > TASKSCHEDULER_MAX_TASKS)
+        ? TASKSCHEDULER_MAX_TASKS
+        : numTasks;
+
+    const uint16_t now = SystemTime_ticks();
+    for (uint8_t t = 0; t < numTableTasks; ++t) {
+        TaskState *ts = &taskStates[t];
+        ts->nextDueTicks = now;
+#if TASKSCHEDULER_PROFILING_ENABLED
+        ts->runCount = 0;
+        ts->maxCounts = 0;
+        ts->totalCounts = 0;
+#endif
+    }
+#if TASKSCHEDULER_PROFILING_ENABLED
+    reportIndex = numTableTasks;
+#endif
+}
+
+#if TASKSCHEDULER_PROFILING_ENABLED
+static void reportTask (
+    const uint8_t t)
+{
+    const TaskScheduler_TaskDesc *td = &taskTable[t];
+    TaskState *ts = &taskStates[t];
+
+    CharString_define(64, msg);
+    CharString_copyP((PGM_P)pgm_read_word(&td->name), &msg);
+    CharString_appendP(PSTR(" p:"), &msg);
+    StringUtils_appendDecimal(pgm_read_word(&td->periodTicks), 1, 0, &msg);
+    CharString_appendP(PSTR(" n:"), &msg);
+    StringUtils_appendDecimal32(ts->runCount, 1, 0, &msg);
+    // times are in microseconds, total in milliseconds
+    CharString_appendP(PSTR(" max:"), &msg);
+    StringUtils_appendDecimal32(ts->maxCounts, 1, 0, &msg);
+    CharString_appendP(PSTR(" avg:"), &msg);
+    StringUtils_appendDecimal32(
+        (ts->runCount != 0) ? (ts->totalCounts / ts->runCount) : 0, 1, 0, &msg);
+    CharString_appendP(PSTR(" tot:"), &msg);
+    StringUtils_appendDecimal32(ts->totalCounts, 1, 3, &msg);
+    Console_printCS(&msg);
+
+    ts->runCount = 0;
+    ts->maxCounts = 0;
+    ts->totalCounts = 0;
+}
+#endif
+
+void TaskScheduler_task (void)
+{
+    for (uint8_t t = 0; t < numTableTasks; ++t) {
+        const TaskScheduler_TaskDesc *td = &taskTable[t];
+        TaskState *ts = &taskStates[t];
+        const uint16_t period = pgm_read_word(&td->periodTicks);
+        const uint16_t startTicks = SystemTime_ticks();
+        if ((period != 0) &&
+            (((int16_t)(startTicks - ts->nextDueTicks)) < 0)) {
+            // not due yet
+            continue;
+        }
+
+        nextDelayTicks = period;
+        TaskScheduler_TaskFunction function =
+            (TaskScheduler_TaskFunction)pgm_read_word(&td->function);
+#if TASKSCHEDULER_PROFILING_ENABLED
+        const uint16_t startCounts = SystemTime_timerCounts();
+        function();
+        uint16_t elapsedCounts = SystemTime_timerCounts() - startCounts;
+        if ((SystemTime_ticks() - startTicks) > 300) {
+            // ran for more than 62ms, close to the 65.5ms timestamp
+            // wraparound. saturate
+            elapsedCounts = 0xFFFF;
+        }
+        if (ts->runCount == 0xFFFF) {
+            // keep the average meaningful by restarting the accumulation
+            ts->runCount = 0;
+            ts->totalCounts = 0;
+        }
+        ts->totalCounts += elapsedCounts;
+        if (elapsedCounts > ts->maxCounts) {
+            ts->maxCounts = elapsedCounts;
+        }
+        ++ts->runCount;
+#else
+        function();
+#endif
+        ts->nextDueTicks = startTicks + nextDelayTicks;
+    }
+
+#if TASKSCHEDULER_PROFILING_ENABLED
+    if ((reportIndex < numTableTasks) &&
+        (((int16_t)(SystemTime_ticks() - nextReportTicks)) >= 0)) {
+        reportTask(reportIndex++);
+        nextReportTicks = SystemTime_ticks() + REPORT_LINE_INTERVAL;
+    }
+#endif
+}
+
+void TaskScheduler_setCurrentTaskDelay (
+    const uint16_t delayTicks)
+{
+    nextDelayTicks = delayTicks;
+}
+
+#if TASKSCHEDULER_PROFILING_ENABLED
+void TaskScheduler_reportStatistics (void)
+{
+    reportIndex = 0;
+    nextReportTicks = SystemTime_ticks();
+}
+#endif
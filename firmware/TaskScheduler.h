@@ -0,0 +1,70 @@
+//
+//  Task Scheduler
+//
+//  What it does:
+//    Runs the mainloop tasks. Each task has a period in system ticks. A task
+//    with a period of 0 runs on every pass through the mainloop. Other tasks
+//    run only when their next-due time has arrived, so that tasks that are
+//    idle most of the time don't cost anything on the other passes.
+//    When profiling is enabled, keeps per-task statistics (number of runs,
+//    and the longest, average and total run time measured in Timer3
+//    counts).
+//
+//  How to use it:
+//    Define a table of TaskScheduler_TaskDesc in program memory and pass it
+//    to TaskScheduler_Initialize. Call TaskScheduler_task in the mainloop.
+//    A task that is busy only now and then (e.g. waiting on the ADC) can
+//    call TaskScheduler_setCurrentTaskDelay while it runs to be called
+//    back sooner than its period.
+//
+//  Hardware resources used:
+//    None (uses SystemTime ticks)
+//
+#ifndef TASKSCHEDULER_H
+#define TASKSCHEDULER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stddef.h>
+#include <avr/pgmspace.h>
+
+#define TASKSCHEDULER_MAX_TASKS 12
+
+// when enabled, each task run is counted and timed with Timer3 counts
+// (1us). costs 8 bytes of RAM per task and two timestamps per task run.
+// off by default to save flash; can be set from the compiler command line
+#ifndef TASKSCHEDULER_PROFILING_ENABLED
+#define TASKSCHEDULER_PROFILING_ENABLED 0
+#endif
+
+typedef void (*TaskScheduler_TaskFunction)(void);
+
+// task table entry. must be in program memory
+typedef struct TaskScheduler_TaskDesc_struct {
+    TaskScheduler_TaskFunction function;
+    uint16_t periodTicks;   // 0 means run every pass
+    PGM_P name;
+} TaskScheduler_TaskDesc;
+
+extern void TaskScheduler_Initialize (
+    const TaskScheduler_TaskDesc *tasks,    // in program memory
+    const uint8_t numTasks);
+
+// runs all tasks that are due
+extern void TaskScheduler_task (void);
+
+// called from within a task with a nonzero period. the task will next be
+// due delayTicks from the start of this run, instead of one period. must
+// be less than 0x8000 ticks
+extern void TaskScheduler_setCurrentTaskDelay (
+    const uint16_t delayTicks);
+
+#if TASKSCHEDULER_PROFILING_ENABLED
+// starts printing per-task statistics to the console. one task is
+// printed every 1/100 second so that the console output buffer
+// doesn't overflow. each task's statistics are reset once printed
+extern void TaskScheduler_reportStatistics (void);
+#endif
+
+#endif  /* TASKSCHEDULER_H */
@@ -6,23 +6,29 @@
 //
 //  How it works:
 //     Two static queues are used, one for transmit and one for receive.
+//     Each is shared by exactly one ISR and the mainloop, so they are
+//     lock-free SPSCByteQueues.
 //
 
 
 #include "UART_async.h"
 
-#include "ByteQueue.h"
+#include "SPSCByteQueue.h"
 #include <avr/io.h>
 #include <string.h>
 
-ByteQueue_define(100, tx_queue);
-ByteQueue_define(100, rx_queue);
+// the SIM800 link is the only user of USART1. when it is not selected the
+// module is left out so its queues don't take up RAM
+#if UART_ASYNC_ENABLED
+
+SPSCByteQueue_define(128, tx_queue, static);
+SPSCByteQueue_define(64, rx_queue, static);
 
 // called to start or continue transmitting
 static void transmit_next_byte (void)
 {
-    if (!ByteQueue_is_empty(&tx_queue)) {
-        const char tx_byte = ByteQueue_pop(&tx_queue);
+    if (!SPSCByteQueue_is_empty(&tx_queue)) {
+        const char tx_byte = SPSCByteQueue_pop(&tx_queue);
         UDR1 = tx_byte;
     } else {
         // no more data - turn off interrupt
@@ -40,8 +46,8 @@ static void start_transmitting (void)
 void UART_init ()
     {
     // initialize transmit and receive queues
-    ByteQueue_clear(&tx_queue);
-    ByteQueue_clear(&rx_queue);
+    SPSCByteQueue_clear(&tx_queue);
+    SPSCByteQueue_clear(&rx_queue);
 
     // set default baud rate
     UART_set_baud_rate(9600);
@@ -53,9 +59,14 @@ void UART_init ()
 }
 
 void UART_set_baud_rate (
-   const uint16_t new_baud_rate)
+   const uint32_t new_baud_rate)
    {
-   uint16_t ubrr1 = ((F_CPU >> 4) / new_baud_rate) - 1;
+   // double speed mode halves the divisor granularity, which keeps the
+   // rate error at 57600 and above within what the receiver tolerates
+   // at 8MHz (57600 is +2.1% instead of -3.5%). rounded to nearest
+   UCSR1A |= (1<<U2X1);
+   uint16_t ubrr1 =
+       (((F_CPU >> 3) + (new_baud_rate >> 1)) / new_baud_rate) - 1;
    UBRR1L = (uint8_t)ubrr1;
    UBRR1H = (uint8_t)((ubrr1 >> 8) & 0x0F);
    }
@@ -65,8 +76,8 @@ bool UART_read_byte (
    {
        bool gotByte = false;
 
-       if (!ByteQueue_is_empty(&rx_queue)) {
-            *byte = ByteQueue_pop(&rx_queue);
+       if (!SPSCByteQueue_is_empty(&rx_queue)) {
+            *byte = SPSCByteQueue_pop(&rx_queue);
             gotByte = true;
        }
 
@@ -78,7 +89,7 @@ bool UART_write_byte (
 {
     bool successful = false;
 
-    if (ByteQueue_push(byte, &tx_queue)) {
+    if (SPSCByteQueue_push(byte, &tx_queue)) {
         successful = true;
         start_transmitting();
     }
@@ -88,7 +99,7 @@ bool UART_write_byte (
 
 bool UART_tx_queue_is_empty ()
    {
-   return ByteQueue_is_empty(&tx_queue);
+   return SPSCByteQueue_is_empty(&tx_queue);
    }
 
 bool UART_write_string (
@@ -97,13 +108,11 @@ bool UART_write_string (
     bool successful = false;
 
     // check if there is enough space left in the tx queue
-    if (strlen(string) <= ByteQueue_spaceRemaining(&tx_queue))
+    if (strlen(string) <= SPSCByteQueue_spaceRemaining(&tx_queue))
     {  // there is enough space in the queue
         // push all bytes onto the queue
-        const char *byte_ptr = string;
-        while ((*byte_ptr) != 0) {
-            ByteQueue_push(*byte_ptr++, &tx_queue);
-        }
+        SPSCByteQueue_pushBlock(
+            (const ByteQueueElement*)string, strlen(string), &tx_queue);
 
         start_transmitting();
         successful = true;
@@ -118,7 +127,7 @@ bool UART_write_stringP (
     bool successful = false;
 
     // check if there is enough space left in the tx queue
-    if (strlen_P(string) <= ByteQueue_spaceRemaining(&tx_queue))
+    if (strlen_P(string) <= SPSCByteQueue_spaceRemaining(&tx_queue))
         {  // there is enough space in the queue
         // push all bytes onto the queue
         PGM_P cp = string;
@@ -127,7 +136,7 @@ bool UART_write_stringP (
             ch = pgm_read_byte(cp);
             ++cp;
             if (ch != 0) {
-                ByteQueue_push(ch, &tx_queue);
+                SPSCByteQueue_push(ch, &tx_queue);
             }
         } while (ch != 0);
 
@@ -145,15 +154,12 @@ bool UART_write_bytes (
     bool successful = false;
 
     // check if there is enough space left in the tx queue
-    if (numBytes <= ByteQueue_spaceRemaining(&tx_queue)) {
+    if (numBytes <= SPSCByteQueue_spaceRemaining(&tx_queue)) {
         // there is enough space in the queue
         if (numBytes > 0) {
             // push all bytes onto the queue
-            const char *byte_ptr = bytes;
-            uint16_t numBytesRemaining = numBytes;
-            while (numBytesRemaining-- > 0) {
-                ByteQueue_push(*byte_ptr++, &tx_queue);
-            }
+            SPSCByteQueue_pushBlock(
+                (const ByteQueueElement*)bytes, numBytes, &tx_queue);
             start_transmitting();
         }
         successful = true;
@@ -162,6 +168,16 @@ bool UART_write_bytes (
     return successful;
 }
 
+uint8_t UART_tx_space_remaining (void)
+{
+    return SPSCByteQueue_spaceRemaining(&tx_queue);
+}
+
+SPSCByteQueue_t* UART_rx_queue (void)
+{
+    return &rx_queue;
+}
+
 bool UART_read_string (
    StringBuffer *str_buf)
    {
@@ -179,9 +195,19 @@ bool UART_read_string (
    return string_is_complete;
    }
 
+void UART_reportQueue (
+    const uint8_t line)
+{
+    if (line == 0) {
+        SPSCByteQueue_reportStatistics(PSTR("UARTTX"), &tx_queue);
+    } else {
+        SPSCByteQueue_reportStatistics(PSTR("UARTRX"), &rx_queue);
+    }
+}
+
 ISR(USART1_RX_vect, ISR_BLOCK)
 {
-    ByteQueue_push(UDR1, &rx_queue);
+    SPSCByteQueue_push(UDR1, &rx_queue);
 }
 
 ISR(USART1_UDRE_vect, ISR_BLOCK)
@@ -193,3 +219,5 @@ ISR(USART1_TX_vect, ISR_BLOCK)
 {
 }
 
+#endif  // UART_ASYNC_ENABLED
+
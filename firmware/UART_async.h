@@ -5,10 +5,12 @@
 //    This interface is designed to work seamlessly with other tasks while
 //    providing asynchronous communications. It uses interrupts to receive
 //    and transmit bytes.
-//    This interface has a 400-byte transmit queue and an 80 byte receive
+//    This interface has a 128-byte transmit queue and a 64 byte receive
 //    queue. The writing functions return false if there is not enough room
 //    in the transmit queue. If the receive queue fills up characters are
 //    lost.
+//    The receive queue can also be consumed directly by a module that
+//    takes an SPSCByteQueue (e.g. SIM800) - see UART_rx_queue().
 //
 //  How to use it:
 //    Upon powerup call UART_init() once.
@@ -16,7 +18,8 @@
 //    read and write data.
 //
 //  Hardware resouces used:
-//    TxD and RxD pins
+//    USART1
+//    TxD (PD3) and RxD (PD2) pins
 //
 
 #ifndef UART_ASYNC_LOADED
@@ -26,13 +29,21 @@
 #include <stdint.h>
 #include <avr/pgmspace.h>
 #include "StringBuffer.h"
+#include "SPSCByteQueue.h"
+
+// set to 1 to build this driver. the SIM800 then talks through it instead
+// of SoftwareSerialTx/SoftwareSerialRx0, which requires the SIM800 TX/RX
+// lines to be wired to RXD1 (PD2, D0) and TXD1 (PD3, D1)
+#define UART_ASYNC_ENABLED 0
 
 // uart initialization. must be called once before calling any of the other
 // functions
 extern void UART_init (void);
 
+// sets the baud rate, using double speed mode for the lowest rate error.
+// at 8MHz 9600, 19200, 38400 and 57600 are usable; 115200 is not (-3.5%)
 extern void UART_set_baud_rate (
-   const uint16_t new_baud_rate);
+   const uint32_t new_baud_rate);
 
 // reads one byte from the uart into byte param, if present. returns true
 // if a byte is present, false if not. 
@@ -62,10 +73,20 @@ extern bool UART_write_bytes (
    const char *bytes,
    const uint16_t numBytes);
 
+// returns the number of bytes that can be written to the transmit queue
+extern uint8_t UART_tx_space_remaining (void);
+
+// returns the receive queue, for a consumer that reads it directly instead
+// of using UART_read_byte. only one consumer may read it
+extern SPSCByteQueue_t* UART_rx_queue (void);
+
 // tries to read one byte from the UART and append it to the string buffer.
 // returns true if the newline character was received
 extern bool UART_read_string (
    StringBuffer *str_buf);
 
+// prints the statistics of the transmit (line 0) or receive (line 1) queue
+extern void UART_reportQueue (
+    const uint8_t line);
 
 #endif   // UART_ASYNC_LOADED
@@ -39,13 +39,21 @@
 static const prog_char crlfP[] = {13,10,0};
 
 /** Circular buffer to hold data from the host before it is sent to the device via the serial port. */
-ByteQueue_define(16, FromUSB_Buffer,)
+SPSCByteQueue_define(16, FromUSB_Buffer,)
 
 /** Circular buffer to hold data from the serial port before it is sent to the host. */
-ByteQueue_define(150, ToUSB_Buffer,)
+SPSCByteQueue_define(256, ToUSB_Buffer,)
 
 static bool USBConnected = false;
 
+// true when the last packet sent was a full bank and nothing has followed
+// it yet. the host treats a full packet as "more to come", so the
+// transfer is ended with a zero length packet
+static bool zeroLengthPacketPending = false;
+
+// bytes sent to the host since the last call to USBTerminal_takeBytesSent
+static uint16_t bytesSent = 0;
+
 /** LUFA CDC Class driver interface configuration and state information. This structure is
  *  passed to all CDC Class driver functions, so that multiple instances of the same class
  *  within a device can be differentiated from one another.
@@ -59,7 +67,7 @@ USB_ClassInfo_CDC_Device_t VirtualSerial_CDC_Interface =
 					{
 						.Address                = CDC_TX_EPADDR,
 						.Size                   = CDC_TXRX_EPSIZE,
-						.Banks                  = 1,
+						.Banks                  = 2,
 					},
 				.DataOUTEndpoint                =
 					{
@@ -93,8 +101,8 @@ void USBTerminal_sendCharsToHostP (
     do {
         ch = pgm_read_byte(cp);
         ++cp;
-        if ((ch != 0) && !ByteQueue_is_full(&ToUSB_Buffer)) {
-            ByteQueue_push(ch, &ToUSB_Buffer);
+        if (ch != 0) {
+            SPSCByteQueue_push(ch, &ToUSB_Buffer);
         }
     } while (ch != 0);
 }
@@ -110,13 +118,11 @@ void USBTerminal_sendCharsToHostCS (
 void USBTerminal_sendCharsToHostCSS (
     const CharStringSpan_t *text)
 {
-    CharString_Iter iter = CharStringSpan_begin(text);
-    CharString_Iter end = CharStringSpan_end(text);
-
     // if the ring buffer fills up we simply drop the rest of the text
-    while ((iter != end) && !ByteQueue_is_full(&ToUSB_Buffer)) {
-        ByteQueue_push(*iter++, &ToUSB_Buffer);
-    }
+    SPSCByteQueue_pushBlock(
+        (const ByteQueueElement*)CharStringSpan_begin(text),
+        CharStringSpan_length(text),
+        &ToUSB_Buffer);
 }
 
 void USBTerminal_sendLineToHost (
@@ -147,45 +153,64 @@ void USBTerminal_sendLineToHostCSS (
     USBTerminal_sendCharsToHostP(crlfP);
 }
 
+// fills endpoint banks from the ToUSB buffer and sends them. the IN
+// endpoint is double banked, so up to two packets can be handed to the
+// USB controller per call. never blocks: a bank is only written when the
+// controller says it's free
+static void sendPacketsToHost (void)
+{
+    if ((USB_DeviceState != DEVICE_STATE_Configured) ||
+        (VirtualSerial_CDC_Interface.State.LineEncoding.BaudRateBPS == 0)) {
+        // nobody listening
+        return;
+    }
+
+    Endpoint_SelectEndpoint(VirtualSerial_CDC_Interface.Config.DataINEndpoint.Address);
+    while (Endpoint_IsINReady()) {
+        /* Copy the contiguous bytes at the head of the buffer into the free bank. The span may
+         * end at the wrap point of the buffer, in which case the next span continues the packet */
+        const ByteQueueElement *span;
+        uint8_t BufferCount = SPSCByteQueue_peekSpan(&ToUSB_Buffer, &span);
+        if (BufferCount == 0) {
+            if (zeroLengthPacketPending) {
+                // end the transfer
+                Endpoint_ClearIN();
+                zeroLengthPacketPending = false;
+            }
+            break;
+        }
+        const uint8_t BankSpace = CDC_TXRX_EPSIZE - Endpoint_BytesInEndpoint();
+        const uint8_t BytesToSend = MIN(BufferCount, BankSpace);
+        Endpoint_Write_Stream_LE(span, BytesToSend, NULL);
+        SPSCByteQueue_commitSpan(BytesToSend, &ToUSB_Buffer);
+        bytesSent += BytesToSend;
+
+        if (Endpoint_BytesInEndpoint() == CDC_TXRX_EPSIZE) {
+            // bank is full - send it
+            Endpoint_ClearIN();
+            zeroLengthPacketPending = true;
+        } else if (SPSCByteQueue_is_empty(&ToUSB_Buffer)) {
+            // flush the partial bank. a short packet ends the transfer
+            Endpoint_ClearIN();
+            zeroLengthPacketPending = false;
+        }
+    }
+}
+
 void USBTerminal_task (void)
 {
 
     /* Only try to read in bytes from the CDC interface if the transmit buffer is not full */
-    if (!(ByteQueue_is_full(&FromUSB_Buffer))) {
+    if (!(SPSCByteQueue_is_full(&FromUSB_Buffer))) {
 	int16_t ReceivedByte = CDC_Device_ReceiveByte(&VirtualSerial_CDC_Interface);
 
 	/* Read bytes from the USB OUT endpoint into the USART transmit buffer */
 	if (!(ReceivedByte < 0)) {
-	    ByteQueue_push(ReceivedByte, &FromUSB_Buffer);
+	    SPSCByteQueue_push(ReceivedByte, &FromUSB_Buffer);
         }
     }
 
-    /* Check if there is any data in the ToUSB buffer */
-    uint16_t BufferCount = ByteQueue_length(&ToUSB_Buffer);
-    if (BufferCount > 0) {
-        Endpoint_SelectEndpoint(VirtualSerial_CDC_Interface.Config.DataINEndpoint.Address);
-
-        /* Check if a packet is already enqueued to the host - if so, we shouldn't try to send more data
-	    * until it completes as there is a chance nothing is listening and a lengthy timeout could occur */
-        if (Endpoint_IsINReady())
-        {
-            /* Never send more than one bank size less one byte to the host at a time, so that we don't block
-	        * while a Zero Length Packet (ZLP) to terminate the transfer is sent if the host isn't listening */
-            uint8_t BytesToSend = MIN(BufferCount, (CDC_TXRX_EPSIZE - 1));
-
-            /* Read bytes from the USART receive buffer into the USB IN endpoint */
-            while (BytesToSend--) {
-                /* Try to send the next byte of data to the host, abort if there is an error without dequeuing */
-                if (CDC_Device_SendByte(&VirtualSerial_CDC_Interface,
-                        ByteQueue_head(&ToUSB_Buffer)) != ENDPOINT_READYWAIT_NoError) {
-                    break;
-                }
-
-                /* Dequeue the already sent byte from the buffer now we have confirmed that no transmission error occurred */
-                ByteQueue_pop(&ToUSB_Buffer);
-            }
-        }
-    }
+    sendPacketsToHost();
 
     CDC_Device_USBTask(&VirtualSerial_CDC_Interface);
     USB_USBTask();
@@ -194,17 +219,34 @@ void USBTerminal_task (void)
 /** Configures the board hardware and chip peripherals for the demo's functionality. */
 void USBTerminal_Initialize (void)
 {
-    ByteQueue_clear(&FromUSB_Buffer);
-    ByteQueue_clear(&ToUSB_Buffer);
+    SPSCByteQueue_clear(&FromUSB_Buffer);
+    SPSCByteQueue_clear(&ToUSB_Buffer);
 
     USB_Init();
 }
 
+void USBTerminal_reportQueue (
+    const uint8_t line)
+{
+    if (line == 0) {
+        SPSCByteQueue_reportStatistics(PSTR("USBTX"), &ToUSB_Buffer);
+    } else {
+        SPSCByteQueue_reportStatistics(PSTR("USBRX"), &FromUSB_Buffer);
+    }
+}
+
 bool USBTerminal_isConnected (void)
 {
 	return USBConnected;
 }
 
+uint16_t USBTerminal_takeBytesSent (void)
+{
+    const uint16_t count = bytesSent;
+    bytesSent = 0;
+    return count;
+}
+
 /** Event handler for the library USB Connection event. */
 void EVENT_USB_Device_Connect(void)
 {
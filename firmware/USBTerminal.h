@@ -49,10 +49,10 @@
         #include <LUFA/Drivers/Peripheral/Serial.h>
         #include <LUFA/Drivers/USB/USB.h>
         #include "CharStringSpan.h"
-        #include "ByteQueue.h"
+        #include "SPSCByteQueue.h"
 
-        extern ByteQueue_t FromUSB_Buffer;
-        extern ByteQueue_t ToUSB_Buffer;
+        extern SPSCByteQueue_t FromUSB_Buffer;
+        extern SPSCByteQueue_t ToUSB_Buffer;
 
     /* Function Prototypes: */
         void USBTerminal_sendCharsToHost (
@@ -77,6 +77,15 @@
         void USBTerminal_Initialize (void);
         bool USBTerminal_isConnected (void);
 
+        // returns the number of bytes sent to the host since the last
+        // call, and resets the count
+        uint16_t USBTerminal_takeBytesSent (void);
+
+        // prints the statistics of the to-host (line 0) or from-host
+        // (line 1) queue
+        void USBTerminal_reportQueue (
+            const uint8_t line);
+
         void EVENT_USB_Device_Connect(void);
         void EVENT_USB_Device_Disconnect(void);
         void EVENT_USB_Device_ConfigurationChanged(void);
@@ -51,10 +51,54 @@
 #include "SDCard.h"
 #include "SoftwareSerialRx0.h"
 #include "SoftwareSerialTx.h"
+#include "UART_async.h"
 #include "ADCManager.h"
 #include "InternalTemperatureMonitor.h"
 #include "WaterLevelDisplay.h"
+#include "SampleHistory.h"
+#include "ConnectScheduler.h"
 #include "RAMSentinel.h"
+#include "TaskScheduler.h"
+
+// period for tasks that only need to run every 1/100 second
+#define TASK_PERIOD_10MS (SYSTEMTIME_TICKS_PER_SECOND / 100)
+// period for sampling the pump input, fast enough to see several low
+// samples in each AC half cycle
+#define TASK_PERIOD_1MS (SYSTEMTIME_TICKS_PER_SECOND / 1000)
+// period for tasks that are idle for seconds at a time. they shorten it
+// themselves while they have work (TaskScheduler_setCurrentTaskDelay)
+#define TASK_PERIOD_1S SYSTEMTIME_TICKS_PER_SECOND
+
+static char systemTimeTaskP[]       PROGMEM = "SystemTime";
+static char adcManagerTaskP[]       PROGMEM = "ADCManager";
+static char tempMonitorTaskP[]      PROGMEM = "TempMonitor";
+static char sim800TaskP[]           PROGMEM = "SIM800";
+static char consoleTaskP[]          PROGMEM = "Console";
+static char usbTerminalTaskP[]      PROGMEM = "USBTerminal";
+static char tcpipConsoleTaskP[]     PROGMEM = "TCPIPConsole";
+static char cellularCommTaskP[]     PROGMEM = "CellularComm";
+static char powerMonitorTaskP[]     PROGMEM = "PowerMonitor";
+static char waterLevelDisplayTaskP[] PROGMEM = "WaterLevelDisplay";
+static char displayTaskP[]          PROGMEM = "Display";
+static char tftTaskP[]              PROGMEM = "TFT";
+
+// mainloop tasks, in the order they run
+static const TaskScheduler_TaskDesc tasks[] PROGMEM = {
+    {SystemTime_task,                   0,                  systemTimeTaskP},
+    {ADCManager_task,                   0,                  adcManagerTaskP},
+    {InternalTemperatureMonitor_task,   TASK_PERIOD_1S,     tempMonitorTaskP},
+    {SIM800_task,                       0,                  sim800TaskP},
+    {Console_task,                      0,                  consoleTaskP},
+    {USBTerminal_task,                  0,                  usbTerminalTaskP},
+    {TCPIPConsole_task,                 0,                  tcpipConsoleTaskP},
+    {CellularComm_task,                 0,                  cellularCommTaskP},
+    {PowerMonitor_task,                 TASK_PERIOD_1MS,    powerMonitorTaskP},
+    {WaterLevelDisplay_task,            TASK_PERIOD_10MS,   waterLevelDisplayTaskP},
+    {Display_task,                      TASK_PERIOD_10MS,   displayTaskP},
+    {TFT_HXD8357D_task,                 0,                  tftTaskP}
+};
+_Static_assert((sizeof(tasks) / sizeof(tasks[0])) <= TASKSCHEDULER_MAX_TASKS,
+    "too many tasks for TASKSCHEDULER_MAX_TASKS");
 
 /** Configures the board hardware and chip peripherals for the demo's functionality. */
 void Initialize (void)
@@ -67,8 +111,12 @@ void Initialize (void)
 
     EEPROMStorage_Initialize();
     SystemTime_Initialize();
+#if !UART_ASYNC_ENABLED
+    // the bit-bang serial link is only used when the SIM800 isn't on the
+    // hardware UART
     SoftwareSerialRx0_Initialize();
     SoftwareSerialTx_Initialize();
+#endif
     Console_Initialize();
     CellularComm_Initialize();
     CellularTCPIP_Initialize();
@@ -81,7 +129,14 @@ void Initialize (void)
     InternalTemperatureMonitor_Initialize();
     RAMSentinel_Initialize();
     USBTerminal_Initialize();
+#if SAMPLEHISTORY_ENABLED
+    SampleHistory_Initialize();
+#endif
+#if CONNECTSCHEDULER_ENABLED
+    ConnectScheduler_Initialize();
+#endif
     WaterLevelDisplay_Initialize();
+    TaskScheduler_Initialize(tasks, sizeof(tasks) / sizeof(tasks[0]));
 }
 
 /** Main program entry point. This routine contains the overall program flow, including initial
@@ -97,27 +152,22 @@ int main(void)
             SystemTime_commenceShutdown();
         }
 
-        // run all the tasks
-        SystemTime_task();
-        ADCManager_task();
-        InternalTemperatureMonitor_task();
-        SIM800_task();
-        Console_task();
-        USBTerminal_task();
-        TCPIPConsole_task();
-        CellularComm_task();
-        PowerMonitor_task();
-        WaterLevelDisplay_task();
-        Display_task();
-        TFT_HXD8357D_task();
-
-        // daily reboot logic, but not in the middle of display task activity
-        if (WaterLevelDisplay_taskIsIdle() &&
-             (!SystemTime_shuttingDown())) {
+        // run the tasks that are due
+        TaskScheduler_task();
+
+        // daily reboot logic, but not in the middle of display task activity.
+        // a persistent session keeps the modem up, so it is ended first
+        if (!SystemTime_shuttingDown()) {
             const uint32_t uptime = SystemTime_uptime();
             const uint32_t rebootIntervalSeconds = (((uint32_t)EEPROMStorage_rebootInterval()) * 60);
             if (uptime > rebootIntervalSeconds) {
-                SystemTime_commenceShutdown();
+                if (WaterLevelDisplay_taskIsIdle()) {
+                    SystemTime_commenceShutdown();
+#if WATERLEVELDISPLAY_SESSION_ENABLED
+                } else {
+                    WaterLevelDisplay_endSession();
+#endif
+                }
             }
         }
     }
@@ -9,6 +9,11 @@
 //
 #include "WaterLevelDisplay.h"
 
+#if WATERLEVELDISPLAY_BINARY_TELEMETRY_ENABLED
+#include <util/crc16.h>
+#endif
+#include <avr/eeprom.h>
+#include "EEPROM_Util.h"
 #include "SystemTime.h"
 #include "EEPROMStorage.h"
 //#include "Thingspeak.h"
@@ -21,9 +26,62 @@
 #include "PowerMonitor.h"
 #include "Display.h"
 #include "InternalTemperatureMonitor.h"
+#include "ConnectScheduler.h"
 
 #define SW_VERSION 10
 
+#if WATERLEVELDISPLAY_SESSION_ENABLED
+// seconds without traffic in persistent session mode before we send a
+// sample report to keep the connection alive
+#define SESSION_HEARTBEAT_INTERVAL 60
+#endif
+
+// a mains or pump change brings the next connection forward. seconds to
+// wait for further changes, so that they go in the same connection
+#define EVENT_CONNECT_DELAY 20
+// minimum seconds from one connection to an event-triggered one
+#define EVENT_CONNECT_MIN_INTERVAL 120
+
+#if WATERLEVELDISPLAY_BINARY_TELEMETRY_ENABLED
+// binary sample frame (multi-byte fields are little-endian):
+//   0      frame version. high bit set to tell it apart from text records
+//   1-2    unit ID
+//   3      software version
+//   4-5    battery millivolts
+//   6      registration status
+//   7      signal quality
+//   8      bit 0: mains on, bit 1: pump on
+//   9-10   temperature
+//   11-12  seconds since connect start
+//   13-14  CRC-16/MCRF4XX (_crc_ccitt_update from 0xFFFF) of bytes 0-12
+// it is sent with a fixed-length CIPSEND, so any byte value may appear
+#define BINARY_FRAME_VERSION 0x81
+#define BINARY_FRAME_LEN 15
+#endif
+
+#if SAMPLEHISTORY_ENABLED
+// when the host has asked for them with "history on", samples from
+// SampleHistory are sent ahead of the current sample, oldest first.
+// otherwise the record is unchanged. as text: H<age>M<mains>P<pump>B<battery>T<temperature>;
+// age is seconds before now. periodic samples have F1 before the ';'.
+// as binary frames:
+//   0      frame version (0x82)
+//   1-4    age in seconds
+//   5      flags (SAMPLEHISTORY_ flags)
+//   6-7    battery millivolts
+//   8-9    temperature
+//   10-11  CRC, as for the sample frame, of bytes 0-9
+#define HISTORY_FRAME_VERSION 0x82
+#define HISTORY_FRAME_LEN 12
+#endif
+
+#if WATERLEVELDISPLAY_SESSION_ENABLED
+// persistent session setting, so that it survives the daily reboot. kept
+// here rather than in EEPROMStorage so that its layout is not disturbed.
+// erased (0xFF) means WATERLEVELDISPLAY_PERSISTENT_SESSION
+static uint8_t persistentSessionEE EEMEM;
+#endif
+
 // water level state
 typedef enum WaterLevel_enum {
     wl_inRange = 'I',
@@ -55,9 +113,135 @@ static SystemTime_t time;   // used to measure how long it took to get a connect
 static bool gotCommandFromHost;
 static SystemTime_t connectStartTime;
 static CharStringSpan_t remainingReplyDataToSend;
+#if WATERLEVELDISPLAY_SESSION_ENABLED
+static SystemTime_t heartbeatTime;
+static bool sessionReconnecting;
+#endif
+#if WATERLEVELDISPLAY_BINARY_TELEMETRY_ENABLED
+static bool binaryTelemetry;
+#endif
+#if SAMPLEHISTORY_ENABLED
+static bool historyUpload;
+static uint8_t historyToSend;
+static uint8_t historySent;
+static uint16_t historyOverwritesAtSend;
+#endif
+static bool eventConnectPending;
+static uint32_t eventConnectAllowedTime;    // uptime seconds
+static bool connectAttempted;
+static bool sampleDelivered;
+static uint16_t connectTime;                // seconds
 
 #define DATA_SENDER_BUFFER_LEN 40
 
+#if WATERLEVELDISPLAY_BINARY_TELEMETRY_ENABLED
+static void appendWord (
+    const uint16_t word,
+    CharString_t *frame)
+{
+    CharString_appendC((char)(word & 0xFF), frame);
+    CharString_appendC((char)(word >> 8), frame);
+}
+
+static void appendCRC (
+    CharString_t *frame)
+{
+    uint16_t crc = 0xFFFF;
+    for (CharString_Iter cp = CharString_begin(frame);
+            cp != CharString_end(frame); ++cp) {
+        crc = _crc_ccitt_update(crc, (uint8_t)*cp);
+    }
+    appendWord(crc, frame);
+}
+
+static void createBinaryFrame (
+    const int32_t secondsSinceLastSample,
+    CharString_t *frame)
+{
+    CharString_clear(frame);
+    CharString_appendC(BINARY_FRAME_VERSION, frame);
+    appendWord(EEPROMStorage_unitID(), frame);
+    CharString_appendC(SW_VERSION, frame);
+    appendWord(CellularComm_batteryMillivolts(), frame);
+    CharString_appendC(CellularComm_registrationStatus(), frame);
+    CharString_appendC(CellularComm_SignalQuality(), frame);
+    CharString_appendC(
+        (PowerMonitor_mainsOn() ? 0x01 : 0) |
+        (PowerMonitor_pumpOn() ? 0x02 : 0), frame);
+    appendWord(InternalTemperatureMonitor_currentTemperature(), frame);
+    appendWord(
+        (secondsSinceLastSample > 0xFFFF)
+        ? 0xFFFF
+        : ((uint16_t)secondsSinceLastSample), frame);
+    appendCRC(frame);
+}
+#endif
+
+#if SAMPLEHISTORY_ENABLED
+static void createHistoryRecord (
+    const SampleHistory_Sample *sample,
+    CharString_t *dataToSend)
+{
+    const uint32_t age = SystemTime_uptime() - sample->uptime;
+#if WATERLEVELDISPLAY_BINARY_TELEMETRY_ENABLED
+    if (binaryTelemetry) {
+        CharString_clear(dataToSend);
+        CharString_appendC(HISTORY_FRAME_VERSION, dataToSend);
+        appendWord((uint16_t)age, dataToSend);
+        appendWord((uint16_t)(age >> 16), dataToSend);
+        CharString_appendC(sample->flags, dataToSend);
+        appendWord(sample->batteryMillivolts, dataToSend);
+        appendWord(sample->temperature, dataToSend);
+        appendCRC(dataToSend);
+        return;
+    }
+#endif
+    CharString_copyP(PSTR("H"), dataToSend);
+    StringUtils_appendDecimal32(age, 1, 0, dataToSend);
+    CharString_appendC('M', dataToSend);
+    CharString_appendC((sample->flags & SAMPLEHISTORY_MAINS_ON) ? '1' : '0', dataToSend);
+    CharString_appendC('P', dataToSend);
+    CharString_appendC((sample->flags & SAMPLEHISTORY_PUMP_ON) ? '1' : '0', dataToSend);
+    CharString_appendC('B', dataToSend);
+    StringUtils_appendDecimal(sample->batteryMillivolts, 1, 0, dataToSend);
+    CharString_appendC('T', dataToSend);
+    StringUtils_appendDecimal(sample->temperature, 1, 0, dataToSend);
+    if (sample->flags & SAMPLEHISTORY_PERIODIC) {
+        CharString_appendP(PSTR("F1"), dataToSend);
+    }
+    CharString_appendP(PSTR(";\n"), dataToSend);
+}
+#endif
+
+static void createTextRecord (
+    const int32_t secondsSinceLastSample,
+    CharString_t *dataToSend)
+{
+    // send per-post data
+    CharString_copyP(PSTR("I"), dataToSend);
+    StringUtils_appendDecimal(EEPROMStorage_unitID(), 1, 0, dataToSend);
+    CharString_appendC('V', dataToSend);
+    StringUtils_appendDecimal(SW_VERSION, 1, 0, dataToSend);
+    CharString_appendC('B', dataToSend);
+    StringUtils_appendDecimal(CellularComm_batteryMillivolts(), 1, 0, dataToSend);
+    CharString_appendC('R', dataToSend);
+    StringUtils_appendDecimal((int)CellularComm_registrationStatus(), 1, 0, dataToSend);
+    CharString_appendC('Q', dataToSend);
+    StringUtils_appendDecimal(CellularComm_SignalQuality(), 1, 0, dataToSend);
+    CharString_appendC('M', dataToSend);
+    CharString_appendC(PowerMonitor_mainsOn() ? '1' : '0', dataToSend);
+    CharString_appendC('P', dataToSend);
+    CharString_appendC(PowerMonitor_pumpOn() ? '1' : '0', dataToSend);
+    CharString_appendC('T', dataToSend);
+    StringUtils_appendDecimal(InternalTemperatureMonitor_currentTemperature(), 1, 0, dataToSend);
+    CharString_appendC('C', dataToSend);
+    StringUtils_appendDecimal(secondsSinceLastSample, 1, 0, dataToSend);
+    CharString_appendC(';', dataToSend);
+
+    // append the delta time between the last sample and now, and append the terminator (Z)
+    CharString_appendP(PSTR("Z\n"), dataToSend);
+}
+
 static bool sampleDataSender (void)
 {
     bool sendComplete = false;
@@ -67,32 +251,25 @@ static bool sampleDataSender (void)
     if (CellularTCPIP_availableSpaceForWriteData() >= DATA_SENDER_BUFFER_LEN) {
         // there is room in the output queue for our data
         CharString_define(DATA_SENDER_BUFFER_LEN, dataToSend);
-        // send per-post data
-        CharString_copyP(PSTR("I"), &dataToSend);
-        StringUtils_appendDecimal(EEPROMStorage_unitID(), 1, 0, &dataToSend);
-        CharString_appendC('V', &dataToSend);
-        StringUtils_appendDecimal(SW_VERSION, 1, 0, &dataToSend);
-        CharString_appendC('B', &dataToSend);
-        StringUtils_appendDecimal(CellularComm_batteryMillivolts(), 1, 0, &dataToSend);
-        CharString_appendC('R', &dataToSend);
-        StringUtils_appendDecimal((int)CellularComm_registrationStatus(), 1, 0, &dataToSend);
-        CharString_appendC('Q', &dataToSend);
-        StringUtils_appendDecimal(CellularComm_SignalQuality(), 1, 0, &dataToSend);
-        CharString_appendC('M', &dataToSend);
-        CharString_appendC(PowerMonitor_mainsOn() ? '1' : '0', &dataToSend);
-        CharString_appendC('P', &dataToSend);
-        CharString_appendC(PowerMonitor_pumpOn() ? '1' : '0', &dataToSend);
-        CharString_appendC('T', &dataToSend);
-        StringUtils_appendDecimal(InternalTemperatureMonitor_currentTemperature(), 1, 0, &dataToSend);
+#if SAMPLEHISTORY_ENABLED
+        if (historySent < historyToSend) {
+            // one history sample per call, ahead of the current sample
+            createHistoryRecord(SampleHistory_sample(historySent++), &dataToSend);
+            CellularTCPIP_writeDataCS(&dataToSend);
+            return false;
+        }
+#endif
         SystemTime_t curTime;
         SystemTime_getCurrentTime(&curTime);
         const int32_t secondsSinceLastSample = SystemTime_diffSec(&curTime, &connectStartTime);
-        CharString_appendC('C', &dataToSend);
-        StringUtils_appendDecimal(secondsSinceLastSample, 1, 0, &dataToSend);
-        CharString_appendC(';', &dataToSend);
-
-        // append the delta time between the last sample and now, and append the terminator (Z)
-        CharString_appendP(PSTR("Z\n"), &dataToSend);
+#if WATERLEVELDISPLAY_BINARY_TELEMETRY_ENABLED
+        if (binaryTelemetry) {
+            createBinaryFrame(secondsSinceLastSample, &dataToSend);
+        } else
+#endif
+        {
+            createTextRecord(secondsSinceLastSample, &dataToSend);
+        }
         sendComplete = true;
         CellularTCPIP_writeDataCS(&dataToSend);
     }
@@ -123,12 +300,100 @@ static void TCPIPSendCompletionCallaback (
         : sds_completedFailed;   
 }
 
+// returns the length of the sample send if it must be fixed, otherwise 0.
+// binary frames can hold any byte value, so they are sent with a fixed
+// length
+static uint16_t sampleSendLength (void)
+{
+#if WATERLEVELDISPLAY_BINARY_TELEMETRY_ENABLED
+    if (binaryTelemetry) {
+#if SAMPLEHISTORY_ENABLED
+        return BINARY_FRAME_LEN + (historyToSend * HISTORY_FRAME_LEN);
+#else
+        return BINARY_FRAME_LEN;
+#endif
+    }
+#endif
+    return 0;
+}
+
+static void startSampleSend (void)
+{
+#if SAMPLEHISTORY_ENABLED
+    // send everything in the history along with the current sample
+    historyToSend = historyUpload ? SampleHistory_count() : 0;
+    historySent = 0;
+    historyOverwritesAtSend = SampleHistory_overwrites();
+#endif
+    // this send reports any change so far
+    eventConnectPending = false;
+    eventConnectAllowedTime = SystemTime_uptime() + EVENT_CONNECT_MIN_INTERVAL;
+    sampleDelivered = false;
+    sendDataStatus = sds_sending;
+    TCPIPConsole_sendData(sampleDataSender, sampleSendLength(),
+        TCPIPSendCompletionCallaback);
+}
+
+static void recordConnectAttempt (void)
+{
+#if CONNECTSCHEDULER_ENABLED
+    if (connectAttempted) {
+        connectAttempted = false;
+        ConnectScheduler_recordAttempt(
+            sampleDelivered, connectTime, CellularComm_SignalQuality());
+    }
+#endif
+}
+
+#if SAMPLEHISTORY_ENABLED
+static void discardSentHistory (void)
+{
+    // samples overwritten during the send shifted the ones we sent
+    const uint16_t overwritten =
+        SampleHistory_overwrites() - historyOverwritesAtSend;
+    SampleHistory_discard(
+        (overwritten >= historyToSend)
+        ? 0
+        : (historyToSend - overwritten));
+}
+#endif
+
+static void powerStateChanged (
+    const bool mainsOn,
+    const bool pumpOn)
+{
+#if SAMPLEHISTORY_ENABLED
+    SampleHistory_takeSample(false);
+#endif
+    eventConnectPending = true;
+}
+
+static void scheduleEventConnect (void)
+{
+    const uint32_t uptime = SystemTime_uptime();
+    const uint32_t delay =
+        ((eventConnectAllowedTime > uptime) &&
+         ((eventConnectAllowedTime - uptime) > EVENT_CONNECT_DELAY))
+        ? (eventConnectAllowedTime - uptime)
+        : EVENT_CONNECT_DELAY;
+    SystemTime_t eventConnectTime;
+    SystemTime_getCurrentTime(&eventConnectTime);
+    eventConnectTime.seconds += delay;
+    // only ever bring the connection forward. later changes that
+    // come before it are coalesced into it
+    if (eventConnectTime.seconds < nextConnectTime.seconds) {
+        SystemTime_copy(&eventConnectTime, &nextConnectTime);
+    }
+}
+
 static void IPDataCallback (
-    const CharString_t *ipData)
+    const CharStringSpan_t *ipData,
+    const uint16_t remaining)
 {
     // RAMSentinel_printStackPtr();
-    for (int i = 0; i < CharString_length(ipData); ++i) {
-        const char c = CharString_at(ipData, i);
+    for (CharString_Iter cp = CharStringSpan_begin(ipData);
+            cp != CharStringSpan_end(ipData); ++cp) {
+        const char c = *cp;
         if ((c == '\r') || (c == '\n')) {
             // got command terminator
             if (!CharString_isEmpty(&CommandProcessor_incomingCommand)) {
@@ -166,6 +431,42 @@ static void enableTCPIP (void)
     TCPIPConsole_enable(false);
 }
 
+#if WATERLEVELDISPLAY_SESSION_ENABLED
+static bool sessionShouldPersist (void)
+{
+    return WaterLevelDisplay_persistentSession() &&
+        PowerMonitor_mainsOn() &&
+        TCPIPConsole_isEnabled() &&
+        (!SystemTime_shuttingDown());
+}
+
+static void enterSessionIdle (void)
+{
+    // connection stays up. the heartbeat is measured from the last exchange
+    SystemTime_futureTime(SESSION_HEARTBEAT_INTERVAL * 100, &heartbeatTime);
+    sessionReconnecting = false;
+    wldState = wlds_sessionIdle;
+}
+#endif
+
+static void scheduleNextConnectTime (
+    const bool adjustForOutcomes)
+{
+    // determine when to contact host
+    const uint16_t loggingInterval = EEPROMStorage_LoggingUpdateInterval();
+    SystemTime_t curTime;
+    SystemTime_getCurrentTime(&curTime);
+    nextConnectTime.seconds =
+        (((curTime.seconds + (loggingInterval / 2)) / loggingInterval) + 1) * loggingInterval;
+    nextConnectTime.seconds += EEPROMStorage_LoggingUpdateDelay();
+    nextConnectTime.hundredths = 0;
+#if CONNECTSCHEDULER_ENABLED
+    if (adjustForOutcomes) {
+        ConnectScheduler_adjustNextConnectTime(&curTime, loggingInterval, &nextConnectTime);
+    }
+#endif
+}
+
 void initiatePowerdown (void)
 {
     // give it a little while to properly close the connection
@@ -176,6 +477,12 @@ void initiatePowerdown (void)
 
 void transitionPerCommandMode(void)
 {
+#if WATERLEVELDISPLAY_SESSION_ENABLED
+    if (sessionShouldPersist()) {
+        // keep the connection up. the host can send more commands at any time
+        enterSessionIdle();
+    } else
+#endif
     if (commandMode == cpm_commandBlock) {
         // more commands coming. wait for next command
         wldState = wlds_waitingForHostCommand;
@@ -190,10 +497,22 @@ void WaterLevelDisplay_Initialize (void)
     wldState = wlds_initial;
     commandMode = cpm_singleCommand;
     gotCommandFromHost = false;
+    PowerMonitor_registerForNotification(powerStateChanged);
 }
 
 void WaterLevelDisplay_task (void)
 {
+#if SAMPLEHISTORY_ENABLED
+    SampleHistory_task();
+#endif
+
+    if (eventConnectPending &&
+        ((wldState == wlds_waitingForNextConnectTime) ||
+         (wldState == wlds_sessionIdle))) {
+        eventConnectPending = false;
+        scheduleEventConnect();
+    }
+
     if ((wldState > wlds_waitingForNextConnectTime) &&
         (wldState < wlds_delayBeforeDisable) &&
         SystemTime_timeHasArrived(&time)) {
@@ -222,6 +541,8 @@ void WaterLevelDisplay_task (void)
             break;
         case wlds_waitingForSensorData :
             if (TCPIPConsole_isEnabled()) {
+                connectAttempted = true;
+                sampleDelivered = false;
                 wldState = wlds_waitingForConnection;
             } else {
                 // just a sample interval
@@ -231,8 +552,10 @@ void WaterLevelDisplay_task (void)
             break;
         case wlds_waitingForConnection :
             if (TCPIPConsole_readyToSend()) {
-                sendDataStatus = sds_sending;
-                TCPIPConsole_sendData(sampleDataSender, TCPIPSendCompletionCallaback);
+                SystemTime_t curTime;
+                SystemTime_getCurrentTime(&curTime);
+                connectTime = SystemTime_diffSec(&curTime, &connectStartTime);
+                startSampleSend();
                 wldState = wlds_sendingSampleData;
             }
             break;
@@ -241,9 +564,21 @@ void WaterLevelDisplay_task (void)
                 case sds_sending :
                     break;
                 case sds_completedSuccessfully :
+                    sampleDelivered = true;
+                    recordConnectAttempt();
+#if SAMPLEHISTORY_ENABLED
+                    discardSentHistory();
+#endif
+#if WATERLEVELDISPLAY_SESSION_ENABLED
+                    if (sessionShouldPersist()) {
+                        enterSessionIdle();
+                        break;
+                    }
+#endif
                     wldState = wlds_waitingForHostCommand;
                     break;
                 case sds_completedFailed :
+                    recordConnectAttempt();
                     wldState = wlds_waitingForHostCommand;
                     break;
             }
@@ -285,7 +620,9 @@ void WaterLevelDisplay_task (void)
             if (TCPIPConsole_readyToSend()) {
                 sendDataStatus = sds_sending;
                 CharStringSpan_init(&CommandProcessor_commandReply, &remainingReplyDataToSend);
-                TCPIPConsole_sendData(replyDataSender, TCPIPSendCompletionCallaback);
+                TCPIPConsole_sendData(replyDataSender,
+                    CharString_length(&CommandProcessor_commandReply),
+                    TCPIPSendCompletionCallaback);
                 wldState = wlds_sendingReplyData;
             }
             break;
@@ -317,18 +654,52 @@ void WaterLevelDisplay_task (void)
             break;
         case wlds_done : {
             SystemTime_applyTimeAdjustment();
-
-            // determine when to contact host
-            const uint16_t loggingInterval = EEPROMStorage_LoggingUpdateInterval();
-            SystemTime_t curTime;
-            SystemTime_getCurrentTime(&curTime);
-            nextConnectTime.seconds =
-                (((curTime.seconds + (loggingInterval / 2)) / loggingInterval) + 1) * loggingInterval;
-            nextConnectTime.seconds += EEPROMStorage_LoggingUpdateDelay();
-            nextConnectTime.hundredths = 0;
+            // records attempts that never got to send
+            recordConnectAttempt();
+            scheduleNextConnectTime(true);
             wldState = wlds_waitingForNextConnectTime;
             }
             break;
+#if WATERLEVELDISPLAY_SESSION_ENABLED
+        case wlds_sessionIdle :
+            // connection is kept up. TCPIPConsole reconnects by itself if
+            // the connection drops
+            if (!sessionShouldPersist()) {
+                initiatePowerdown();
+            } else if (gotCommandFromHost) {
+                // host sent a command. handle it right away
+                SystemTime_futureTime(EEPROMStorage_monitorTaskTimeout() * 100, &time);
+                wldState = wlds_waitingForHostCommand;
+            } else if (CellularTCPIP_connectionStatus() != cs_connected) {
+                // connection dropped and TCPIPConsole is reconnecting. give
+                // up and power down if it doesn't come back in time
+                if (!sessionReconnecting) {
+                    SystemTime_futureTime(EEPROMStorage_monitorTaskTimeout() * 100, &time);
+                    sessionReconnecting = true;
+                } else if (SystemTime_timeHasArrived(&time)) {
+                    Console_printP(PSTR("session reconnect timeout"));
+                    initiatePowerdown();
+                }
+            } else if (sessionReconnecting ||
+                       SystemTime_timeHasArrived(&nextConnectTime) ||
+                       SystemTime_timeHasArrived(&heartbeatTime)) {
+                // time for the next sample. it doubles as the heartbeat,
+                // and after a reconnect it tells the host which connection
+                // to push to
+                SystemTime_applyTimeAdjustment();
+                SystemTime_getCurrentTime(&connectStartTime);
+                connectAttempted = true;
+                sampleDelivered = false;
+                // the session is connected, so there is nothing to back
+                // off from
+                scheduleNextConnectTime(false);
+                SystemTime_futureTime(EEPROMStorage_monitorTaskTimeout() * 100, &time);
+                wldState = wlds_waitingForConnection;
+            }
+            break;
+#endif
+        default :
+            break;
     }
 }
 
@@ -342,3 +713,42 @@ WaterLevelDisplayState WaterLevelDisplay_state (void)
     return wldState;
 }
 
+#if WATERLEVELDISPLAY_SESSION_ENABLED
+void WaterLevelDisplay_endSession (void)
+{
+    if (wldState == wlds_sessionIdle) {
+        initiatePowerdown();
+    }
+}
+
+void WaterLevelDisplay_setPersistentSession (
+    const bool enabled)
+{
+    EEPROM_write(&persistentSessionEE, enabled ? 1 : 0);
+}
+
+bool WaterLevelDisplay_persistentSession (void)
+{
+    const uint8_t persistentSession = EEPROM_read(&persistentSessionEE);
+    return (persistentSession == 0xFF)
+        ? WATERLEVELDISPLAY_PERSISTENT_SESSION
+        : (persistentSession != 0);
+}
+#endif
+
+#if WATERLEVELDISPLAY_BINARY_TELEMETRY_ENABLED
+void WaterLevelDisplay_setBinaryTelemetry (
+    const bool binary)
+{
+    binaryTelemetry = binary;
+}
+#endif
+
+#if SAMPLEHISTORY_ENABLED
+void WaterLevelDisplay_setHistoryUpload (
+    const bool upload)
+{
+    historyUpload = upload;
+}
+#endif
+
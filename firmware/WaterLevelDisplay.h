@@ -9,6 +9,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "CharString.h"
+#include "SampleHistory.h"
 
 typedef enum WaterLevelDisplayState_enum {
     wlds_initial,
@@ -21,17 +22,67 @@ typedef enum WaterLevelDisplayState_enum {
     wlds_sendingReplyData,
     wlds_delayBeforeDisable,
     wlds_waitingForCellularCommDisable,
-    wlds_done
+    wlds_done,
+    wlds_sessionIdle
 } WaterLevelDisplayState;
 
+// set to 1 to build in persistent session mode (see
+// WaterLevelDisplay_setPersistentSession)
+#ifndef WATERLEVELDISPLAY_SESSION_ENABLED
+#define WATERLEVELDISPLAY_SESSION_ENABLED 0
+#endif
+
+// set to 1 to have persistent session mode on until the host sets it.
+// the host's setting is kept in EEPROM
+#define WATERLEVELDISPLAY_PERSISTENT_SESSION 0
+
+// set to 1 to build in the compact binary sample frame. only hosts that
+// ask for it with "telemetry binary" use it
+#ifndef WATERLEVELDISPLAY_BINARY_TELEMETRY_ENABLED
+#define WATERLEVELDISPLAY_BINARY_TELEMETRY_ENABLED 0
+#endif
+
 // sets up control pins. called once at power-up
 extern void WaterLevelDisplay_Initialize (void);
 
 // called in each iteration of the mainloop
 extern void WaterLevelDisplay_task (void);
 
+// true when the cellular module is off and nothing is in progress, so
+// the device can reboot
 extern bool WaterLevelDisplay_taskIsIdle (void);
 
 extern WaterLevelDisplayState WaterLevelDisplay_state (void);
 
+#if WATERLEVELDISPLAY_SESSION_ENABLED
+// powers down the connection if a persistent session is idle, so that a
+// reboot can follow. the session comes back at the next sample time
+extern void WaterLevelDisplay_endSession (void);
+
+// in persistent session mode the cellular connection is kept up between
+// samples while mains power is on, so the host can send commands (such as
+// "data" with a new water level) at any time instead of waiting for the
+// next sample. the host turns it on with the "session on" command, and
+// the setting survives reboots
+extern void WaterLevelDisplay_setPersistentSession (
+    const bool enabled);
+extern bool WaterLevelDisplay_persistentSession (void);
+#endif
+
+#if WATERLEVELDISPLAY_BINARY_TELEMETRY_ENABLED
+// selects the compact binary sample frame instead of the text record.
+// the host turns this on with the "telemetry binary" command
+extern void WaterLevelDisplay_setBinaryTelemetry (
+    const bool binary);
+#endif
+
+#if SAMPLEHISTORY_ENABLED
+// sends the samples in SampleHistory ahead of each sample record, in the
+// selected telemetry format. off until the host turns it on with the
+// "history on" command, so hosts that don't know the history records get
+// the same records as before
+extern void WaterLevelDisplay_setHistoryUpload (
+    const bool upload);
+#endif
+
 #endif  // WATERLEVELDISPLAY_H
@@ -0,0 +1,268 @@
+//
+//  Host benchmarks
+//
+//  What it does:
+//    Times the hot paths of the hardware-independent modules on the host:
+//    number formatting and scanning, SystemTime arithmetic, the SIM800
+//    response parser and its table lookups over a recorded transcript,
+//    command execution and the display's rectangle generation. Host
+//    timings don't carry over to the AVR in absolute terms, but they show
+//    whether a change makes a path faster or slower.
+//
+//  How to use it:
+//    "make bench", or run ./Benchmark [iterations]
+//
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "HostHAL.h"
+#include "CharString.h"
+#include "CharStringSpan.h"
+#include "StringUtils.h"
+#include "SPSCByteQueue.h"
+#include "SystemTime.h"
+#include "SIM800.h"
+#include "SoftwareSerialTx.h"
+#include "SoftwareSerialRx0.h"
+#include "CommandProcessor.h"
+#include "Display.h"
+#include "SIM800Transcript.h"
+
+static uint32_t iterations = 100000;
+
+// sum of results, printed so the compiler can't discard the work
+static volatile uint32_t sink;
+
+static uint64_t nowNs (void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (((uint64_t)ts.tv_sec) * 1000000000ULL) + ts.tv_nsec;
+}
+
+static void report (
+    const char* name,
+    const uint64_t elapsedNs,
+    const uint32_t ops,
+    const char* unit)
+{
+    printf("%-32s %10.1f ns/%s\n", name, ((double)elapsedNs) / ops, unit);
+}
+
+static void benchAppendDecimal (void)
+{
+    CharString_define(16, str);
+    const uint64_t start = nowNs();
+    for (uint32_t i = 0; i < iterations; ++i) {
+        CharString_clear(&str);
+        StringUtils_appendDecimal((int16_t)(i - 15000), 1, 2, &str);
+        sink += CharString_length(&str);
+    }
+    report("StringUtils_appendDecimal", nowNs() - start, iterations, "call");
+}
+
+static void benchScanInteger (void)
+{
+    CharString_define(16, str);
+    CharString_copyP(PSTR("12345,678"), &str);
+    const uint64_t start = nowNs();
+    for (uint32_t i = 0; i < iterations; ++i) {
+        CharStringSpan_t span;
+        CharStringSpan_init(&str, &span);
+        bool isValid;
+        int16_t value;
+        StringUtils_scanInteger(&span, &isValid, &value, &span);
+        sink += value;
+    }
+    report("StringUtils_scanInteger", nowNs() - start, iterations, "call");
+}
+
+static void benchSystemTime (void)
+{
+    const uint64_t start = nowNs();
+    for (uint32_t i = 0; i < iterations; ++i) {
+        SystemTime_t future;
+        SystemTime_t now;
+        SystemTime_futureTime(i % 6000, &future);
+        SystemTime_getCurrentTime(&now);
+        sink += SystemTime_timeHasArrived(&future);
+        sink += SystemTime_diffSec(&future, &now);
+    }
+    report("SystemTime future/arrived/diff", nowNs() - start, iterations, "call");
+}
+
+static void countResponse (
+    const SIM800_ResponseMessage msg)
+{
+    ++sink;
+}
+
+static void countIPData (
+    const CharStringSpan_t *ipData,
+    const uint16_t remaining)
+{
+    sink += CharStringSpan_length(ipData);
+}
+
+static void benchSIM800Parser (void)
+{
+    SIM800_setResponseMessageCallback(countResponse);
+    SIM800_setIPDataCallback(countIPData);
+
+    SPSCByteQueue_t *rxQueue = SoftwareSerial_rx0Queue();
+    const size_t length = sizeof(SIM800Transcript) - 1;
+    const uint32_t passes = (iterations / 100) + 1;
+    const uint64_t start = nowNs();
+    for (uint32_t p = 0; p < passes; ++p) {
+        size_t sent = 0;
+        while (sent < length) {
+            // deliver a few bytes at a time, as the serial receiver does
+            // between mainloop passes
+            size_t count = length - sent;
+            if (count > 8) {
+                count = 8;
+            }
+            sent += SPSCByteQueue_pushBlock(
+                (const ByteQueueElement*)&SIM800Transcript[sent], count, rxQueue);
+            SIM800_task();
+        }
+    }
+    while (!SPSCByteQueue_is_empty(rxQueue)) {
+        SIM800_task();
+    }
+    report("SIM800 response parser", nowNs() - start, passes * length, "byte");
+}
+
+// the response message table is defined in SIM800.c
+extern PGM_P SIM800_ResponseMessageTable[];
+
+// classifies each line of the transcript against the response message
+// table the two ways: character by character as it arrives, and by
+// looking up the whole line once it has ended
+static void benchResponseLookup (void)
+{
+    const size_t length = sizeof(SIM800Transcript) - 1;
+    const uint32_t passes = (iterations / 100) + 1;
+    uint32_t lines = 0;
+    uint64_t start = nowNs();
+    for (uint32_t p = 0; p < passes; ++p) {
+        StringUtils_Lookup_t lookup;
+        StringUtils_beginLookup(rm_unrecognized, &lookup);
+        for (size_t i = 0; i < length; ++i) {
+            const char ch = SIM800Transcript[i];
+            if ((ch == '\r') || (ch == '\n')) {
+                if (lookup.length != 0) {
+                    sink += StringUtils_lookupResult(
+                        SIM800_ResponseMessageTable, rm_unrecognized, &lookup);
+                    ++lines;
+                    StringUtils_beginLookup(rm_unrecognized, &lookup);
+                }
+            } else {
+                StringUtils_lookupChar(ch, SIM800_ResponseMessageTable, &lookup);
+            }
+        }
+    }
+    report("response lookup, incremental", nowNs() - start, lines, "line");
+
+    CharString_define(64, line);
+    lines = 0;
+    start = nowNs();
+    for (uint32_t p = 0; p < passes; ++p) {
+        CharString_clear(&line);
+        for (size_t i = 0; i < length; ++i) {
+            const char ch = SIM800Transcript[i];
+            if ((ch == '\r') || (ch == '\n')) {
+                if (!CharString_isEmpty(&line)) {
+                    CharStringSpan_t lineSpan;
+                    CharStringSpan_init(&line, &lineSpan);
+                    sink += StringUtils_lookupString(
+                        &lineSpan, SIM800_ResponseMessageTable, rm_unrecognized);
+                    ++lines;
+                    CharString_clear(&line);
+                }
+            } else {
+                CharString_appendC(ch, &line);
+            }
+        }
+    }
+    report("response lookup, whole line", nowNs() - start, lines, "line");
+}
+
+static void benchCommandProcessor (void)
+{
+    static const char* commands[] = {
+        "get logInterval",
+        "get minCSQ",
+        "set retryDelay 60",
+        "get sched",
+        "status"
+    };
+    const uint32_t numCommands = sizeof(commands) / sizeof(commands[0]);
+
+    CharString_define(32, command);
+    const uint64_t start = nowNs();
+    for (uint32_t i = 0; i < iterations; ++i) {
+        CharString_copy(commands[i % numCommands], &command);
+        CharStringSpan_t commandSpan;
+        CharStringSpan_init(&command, &commandSpan);
+        CharString_clear(&CommandProcessor_commandReply);
+        sink += CommandProcessor_executeCommand(&commandSpan, &CommandProcessor_commandReply);
+    }
+    report("CommandProcessor_executeCommand", nowNs() - start, iterations, "command");
+}
+
+static uint32_t drawRectangles (void)
+{
+    uint32_t count = 0;
+    const TFT_HXD8357D_Rectangle *rect;
+    while ((rect = HostHAL_rectangleSource()()) != NULL) {
+        sink += rect->height;
+        ++count;
+    }
+    while (HostHAL_textSource()() != NULL) {
+    }
+    return count;
+}
+
+static void benchDisplay (void)
+{
+    Display_Initialize();
+    Display_task();
+    drawRectangles();
+
+    const uint32_t updates = (iterations / 10) + 1;
+    uint32_t rectangles = 0;
+    const uint64_t start = nowNs();
+    for (uint32_t i = 0; i < updates; ++i) {
+        const uint32_t timestamp = i;
+        Display_setWaterLevel(20 + (i % 60), &timestamp);
+        rectangles += drawRectangles();
+    }
+    report("Display level update", nowNs() - start, updates, "update");
+    printf("%-32s %10.1f\n", "  rectangles per update", ((double)rectangles) / updates);
+}
+
+int main (
+    int argc,
+    char** argv)
+{
+    if (argc > 1) {
+        iterations = strtoul(argv[1], NULL, 10);
+    }
+
+    HostHAL_setConsoleQuiet(true);
+    SystemTime_Initialize();
+    SoftwareSerialTx_Initialize();
+    SIM800_Initialize(SoftwareSerial_rx0Queue(), ps_b, 5);
+
+    benchAppendDecimal();
+    benchScanInteger();
+    benchSystemTime();
+    benchSIM800Parser();
+    benchResponseLookup();
+    benchCommandProcessor();
+    benchDisplay();
+
+    printf("(%u)\n", (unsigned)(sink & 0xFF));
+    return 0;
+}
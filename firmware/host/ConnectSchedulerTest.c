@@ -0,0 +1,119 @@
+//
+//  Connect scheduler test
+//
+//  What it does:
+//    Records sequences of connect outcomes and checks where
+//    ConnectScheduler_adjustNextConnectTime moves the next connect time:
+//    a quick retry after a failure with good signal or with connects that
+//    are usually quick, backing off further when most attempts fail, and
+//    skipping every other interval while the average signal quality is
+//    below the minimum.
+//
+//  How to use it:
+//    "make test", or run ./ConnectSchedulerTest
+//
+#include "ConnectScheduler.h"
+#include "HostTest.h"
+
+#define LOGGING_INTERVAL 3600
+#define NOW 1000
+#define NEXT_ON_GRID LOGGING_INTERVAL
+#define MIN_CSQ 10
+#define RETRY_DELAY 120
+#define CHEAP_CONNECT_TIME 30
+
+#define GOOD_CSQ 20
+#define POOR_CSQ 5
+#define UNKNOWN_CSQ 99
+#define SLOW_CONNECT 60
+#define QUICK_CONNECT 10
+
+// returns the next connect time after the given outcomes, as seconds
+// past the next grid point
+static uint32_t delayAfter (
+    const char* outcomes,           // 's' success, 'f' failure
+    const uint16_t connectTime,     // for the successes
+    const uint8_t csq)              // for the failures
+{
+    ConnectScheduler_Initialize();
+    for (const char* o = outcomes; *o != 0; ++o) {
+        if (*o == 's') {
+            ConnectScheduler_recordAttempt(true, connectTime, GOOD_CSQ);
+        } else {
+            ConnectScheduler_recordAttempt(false, 0, csq);
+        }
+    }
+    SystemTime_t curTime = {NOW, 0};
+    SystemTime_t nextConnectTime = {NEXT_ON_GRID, 0};
+    ConnectScheduler_adjustNextConnectTime(
+        &curTime, LOGGING_INTERVAL, &nextConnectTime);
+    return nextConnectTime.seconds - NEXT_ON_GRID;
+}
+
+// as delayAfter, for successes only, with the given signal qualities
+static uint32_t delayAfterSuccesses (
+    const uint8_t* csqs,
+    const uint8_t count)
+{
+    ConnectScheduler_Initialize();
+    for (uint8_t i = 0; i < count; ++i) {
+        ConnectScheduler_recordAttempt(true, SLOW_CONNECT, csqs[i]);
+    }
+    SystemTime_t curTime = {NOW, 0};
+    SystemTime_t nextConnectTime = {NEXT_ON_GRID, 0};
+    ConnectScheduler_adjustNextConnectTime(
+        &curTime, LOGGING_INTERVAL, &nextConnectTime);
+    return nextConnectTime.seconds - NEXT_ON_GRID;
+}
+
+int main (void)
+{
+    ConnectScheduler_setMinCSQ(MIN_CSQ);
+    ConnectScheduler_setRetryDelay(RETRY_DELAY);
+    ConnectScheduler_setMaxBackoff(CONNECTSCHEDULER_DEFAULT_MAX_BACKOFF);
+    ConnectScheduler_setCheapConnectTime(CHEAP_CONNECT_TIME);
+
+    const int32_t retry = (NOW + RETRY_DELAY) - NEXT_ON_GRID;
+
+    // nothing to go on, or all well
+    HostTest_check(delayAfter("", SLOW_CONNECT, GOOD_CSQ) == 0);
+    HostTest_check(delayAfter("ss", SLOW_CONNECT, GOOD_CSQ) == 0);
+
+    // a failure with good signal is retried soon
+    HostTest_check((int32_t)delayAfter("sf", SLOW_CONNECT, GOOD_CSQ) == retry);
+    // with poor signal it skips an interval, unless connects are quick
+    HostTest_check(delayAfter("sf", SLOW_CONNECT, POOR_CSQ) == LOGGING_INTERVAL);
+    HostTest_check((int32_t)delayAfter("sf", QUICK_CONNECT, POOR_CSQ) == retry);
+    // a second failure with good signal skips an interval, unless
+    // connects are quick
+    HostTest_check(delayAfter("sff", SLOW_CONNECT, GOOD_CSQ) == LOGGING_INTERVAL);
+    HostTest_check((int32_t)delayAfter("sff", QUICK_CONNECT, GOOD_CSQ) == retry);
+
+    // three failures with good signal skip 3 intervals when half the
+    // attempts worked, and 7 when most failed
+    HostTest_check(delayAfter("sssfff", SLOW_CONNECT, GOOD_CSQ) == (3 * LOGGING_INTERVAL));
+    HostTest_check(delayAfter("sfff", SLOW_CONNECT, GOOD_CSQ) == (7 * LOGGING_INTERVAL));
+    // too few attempts to judge the ratio
+    HostTest_check(delayAfter("ff", SLOW_CONNECT, GOOD_CSQ) == LOGGING_INTERVAL);
+
+    // backing off stops at the limit
+    ConnectScheduler_setMaxBackoff(2);
+    HostTest_check(delayAfter("sfff", SLOW_CONNECT, GOOD_CSQ) == (2 * LOGGING_INTERVAL));
+    ConnectScheduler_setMaxBackoff(CONNECTSCHEDULER_DEFAULT_MAX_BACKOFF);
+
+    // after a success, every other interval is skipped while the average
+    // signal quality is below the minimum. one poor reading after good
+    // ones doesn't do it, and unknown readings don't count
+    const uint8_t poor[] = {POOR_CSQ};
+    const uint8_t goodThenPoor[] = {GOOD_CSQ, GOOD_CSQ, POOR_CSQ};
+    const uint8_t poorThenGood[] = {POOR_CSQ, POOR_CSQ, GOOD_CSQ};
+    const uint8_t unknown[] = {UNKNOWN_CSQ, UNKNOWN_CSQ};
+    const uint8_t unknownThenPoor[] = {UNKNOWN_CSQ, POOR_CSQ, UNKNOWN_CSQ};
+    HostTest_check(delayAfterSuccesses(poor, 1) == LOGGING_INTERVAL);
+    HostTest_check(delayAfterSuccesses(goodThenPoor, 3) == 0);
+    HostTest_check(delayAfterSuccesses(poorThenGood, 3) == LOGGING_INTERVAL);
+    HostTest_check(delayAfterSuccesses(unknown, 2) == 0);
+    HostTest_check(delayAfterSuccesses(unknownThenPoor, 3) == LOGGING_INTERVAL);
+
+    return HostTest_finish("ConnectSchedulerTest");
+}
@@ -0,0 +1,192 @@
+//
+//  Display level update test
+//
+//  What it does:
+//    Draws what the display module asks for into a model of the screen,
+//    the way the TFT driver does (rectangles first, then text), and steps
+//    the water level through rises, falls, repeats and changes that move
+//    the water line by zero pixels. After each step it checks the band
+//    rectangle rs_drawLevelDelta produced, that rs_eraseLevelText only
+//    painted over the old level text, and that the whole tank interior is
+//    air above the water line and water below it, so that no trace of
+//    the old line or text is left.
+//    Text is modelled as a box in its background color; the glyphs
+//    themselves aren't drawn.
+//
+//  How to use it:
+//    "make test", or run ./DisplayTest
+//
+#include <stdlib.h>
+#include "HostHAL.h"
+#include "Display.h"
+#include "DisplayFonts.h"
+#include "TFT_HXD8357D.h"
+#include "SystemTime.h"
+#include "HostTest.h"
+
+// tank geometry, as in Display.c
+#define TANK_WIDTH 300
+#define TANK_HEIGHT 240
+#define TANK_X 90
+#define TANK_Y 40
+#define TANK_WALL_THICKNESS 8
+#define WATER_GAP_AT_TOP 15
+#define WATER_HEIGHT (TANK_HEIGHT - (TANK_WALL_THICKNESS + WATER_GAP_AT_TOP))
+#define TANK_INTERIOR_X (TANK_X + TANK_WALL_THICKNESS)
+#define TANK_INTERIOR_WIDTH (TANK_WIDTH - (2 * TANK_WALL_THICKNESS))
+#define TANK_INTERIOR_TOP (TANK_Y + WATER_GAP_AT_TOP)
+#define TANK_INTERIOR_BOTTOM (TANK_Y + (TANK_HEIGHT - TANK_WALL_THICKNESS))
+#define LEVEL_TEXT_X ((TANK_X + (TANK_WIDTH / 2)) - 20)
+
+#define MAX_RECTANGLES 16
+
+static uint16_t screen[TFT_HXD8357D_height][TFT_HXD8357D_width];
+
+// the rectangles drawn by the latest update
+static TFT_HXD8357D_Rectangle rectangles[MAX_RECTANGLES];
+static int numRectangles;
+
+static void fill (
+    const uint16_t x,
+    const uint16_t y,
+    const uint16_t width,
+    const uint16_t height,
+    const uint16_t color)
+{
+    HostTest_check(((x + width) <= TFT_HXD8357D_width) &&
+                   ((y + height) <= TFT_HXD8357D_height));
+    for (uint16_t row = y; row < (y + height); ++row) {
+        for (uint16_t col = x; col < (x + width); ++col) {
+            screen[row][col] = color;
+        }
+    }
+}
+
+static void draw (void)
+{
+    numRectangles = 0;
+    const TFT_HXD8357D_Rectangle *rect;
+    while ((rect = HostHAL_rectangleSource()()) != NULL) {
+        HostTest_check(rect->height != 0);
+        if (numRectangles < MAX_RECTANGLES) {
+            rectangles[numRectangles++] = *rect;
+        }
+        fill(rect->x, rect->y, rect->width, rect->height, rect->color);
+    }
+    const TFT_HXD8357D_Text *text;
+    while ((text = HostHAL_textSource()()) != NULL) {
+        uint16_t width = 0;
+        for (CharString_Iter iter = CharStringSpan_begin(&text->chars);
+             iter != CharStringSpan_end(&text->chars); ++iter) {
+            width += DisplayFonts_charWidth(DisplayFonts_primary(), *iter);
+        }
+        fill(text->x, text->y, width,
+             DisplayFonts_fontHeight(DisplayFonts_primary()), text->bgColor);
+    }
+}
+
+static uint16_t waterLineY (
+    const int8_t level)
+{
+    return TANK_Y + WATER_GAP_AT_TOP + ((level > 0)
+        ? ((((uint16_t)(100 - level)) * WATER_HEIGHT) / 100)
+        : WATER_HEIGHT);
+}
+
+// checks that the interior is air above the water line and water below
+static void checkInterior (
+    const int8_t level)
+{
+    const uint16_t lineY = waterLineY(level);
+    uint32_t wrongPixels = 0;
+    for (uint16_t row = TANK_INTERIOR_TOP; row < TANK_INTERIOR_BOTTOM; ++row) {
+        const uint16_t expected = (row < lineY) ? HX8357_WHITE : HX8357_BLUE;
+        for (uint16_t col = TANK_INTERIOR_X;
+             col < (TANK_INTERIOR_X + TANK_INTERIOR_WIDTH); ++col) {
+            if (screen[row][col] != expected) {
+                ++wrongPixels;
+            }
+        }
+    }
+    if (!HostTest_check(wrongPixels == 0)) {
+        printf("  level %d: %u pixels wrong\n", level, (unsigned)wrongPixels);
+    }
+}
+
+static void setLevel (
+    const int8_t fromLevel,
+    const int8_t toLevel)
+{
+    const uint32_t timestamp = 1000 + toLevel;
+    Display_setWaterLevel(toLevel, &timestamp);
+    draw();
+
+    // the band between the old and new lines is the only rectangle the
+    // full width of the interior
+    const uint16_t fromY = waterLineY(fromLevel);
+    const uint16_t toY = waterLineY(toLevel);
+    int numBands = 0;
+    for (int r = 0; r < numRectangles; ++r) {
+        const TFT_HXD8357D_Rectangle *rect = &rectangles[r];
+        if ((rect->x == TANK_INTERIOR_X) &&
+            (rect->width == TANK_INTERIOR_WIDTH)) {
+            ++numBands;
+            if (toY < fromY) {
+                // rose
+                HostTest_check(rect->y == toY);
+                HostTest_check(rect->height == (fromY - toY));
+                HostTest_check(rect->color == HX8357_BLUE);
+            } else {
+                // fell
+                HostTest_check(rect->y == fromY);
+                HostTest_check(rect->height == (toY - fromY));
+                HostTest_check(rect->color == HX8357_WHITE);
+            }
+        } else {
+            // everything else erases the old level text
+            HostTest_check(rect->x == LEVEL_TEXT_X);
+        }
+    }
+    if (!HostTest_check(numBands == ((fromY == toY) ? 0 : 1))) {
+        printf("  %d to %d: %d bands\n", fromLevel, toLevel, numBands);
+    }
+    HostTest_check(numRectangles <= 3);
+
+    checkInterior(toLevel);
+}
+
+int main (void)
+{
+    static const int8_t levels[] = {
+        50,     // rising from unknown
+        80,     // rising
+        30,     // falling
+        30,     // equal
+        31,     // rising one percent
+        14,     // text moves above the line
+        15,     // and back below it
+        10,
+        0,      // falling to the bottom
+        -1,     // unknown: same line as empty, a zero height band
+        100,    // full
+        99,
+        5,
+        100
+    };
+    const int numLevels = sizeof(levels) / sizeof(levels[0]);
+
+    HostHAL_setConsoleQuiet(true);
+    SystemTime_Initialize();
+    Display_Initialize();
+    Display_task();
+    draw();
+    checkInterior(-1);
+
+    int8_t level = -1;
+    for (int i = 0; i < numLevels; ++i) {
+        setLevel(level, levels[i]);
+        level = levels[i];
+    }
+
+    return HostTest_finish("DisplayTest");
+}
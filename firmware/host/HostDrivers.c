@@ -0,0 +1,288 @@
+//
+//  Host stand-ins for drivers
+//
+//  Stand in for the modules that drive hardware directly, so that the
+//  modules that use them can be built and run on the host (see makefile
+//  and HostHAL.h).
+//
+#include <avr/pgmspace.h>
+#include "HostHAL.h"
+#include "SystemTime.h"
+#include "SPSCByteQueue.h"
+#include "SoftwareSerialTx.h"
+#include "SoftwareSerialRx0.h"
+#include "PowerMonitor.h"
+#include "InternalTemperatureMonitor.h"
+#include "WaterLevelDisplay.h"
+#include "Console.h"
+#include "StringUtils.h"
+
+//
+// power monitor
+//
+static bool mainsOn = true;
+static bool pumpOn = false;
+
+void HostHAL_setPowerState (
+    const bool mains,
+    const bool pump)
+{
+    mainsOn = mains;
+    pumpOn = pump;
+}
+
+bool PowerMonitor_mainsOn (void)
+{
+    return mainsOn;
+}
+
+bool PowerMonitor_pumpOn (void)
+{
+    return pumpOn;
+}
+
+//
+// internal temperature
+//
+bool InternalTemperatureMonitor_haveValidSample (void)
+{
+    return false;
+}
+
+int16_t InternalTemperatureMonitor_currentTemperature (void)
+{
+    return 0;
+}
+
+//
+// software serial transmitter. bytes go to the sink set by the host
+// program at the rate of the real one: a start bit, 8 data bits and a
+// stop bit, one bit per SystemTime tick
+//
+#define NUM_CHANNELS 2
+#define TICKS_PER_BYTE 10
+
+typedef struct TxDescriptor_struct {
+    bool isEnabled;
+    uint8_t ticksToStopBit; // 0 when idle
+    SPSCByteQueue_t *txQueue;
+} TxDescriptor;
+static TxDescriptor channels[NUM_CHANNELS];
+static HostHAL_SerialTxSink txSink;
+
+SPSCByteQueue_define(128, txQueue0, static);
+SPSCByteQueue_define(16, txQueue1, static);
+
+static void systemTimeTickTask (void)
+{
+    for (int channelIndex = 0; channelIndex < NUM_CHANNELS; ++channelIndex) {
+        TxDescriptor *channel = &channels[channelIndex];
+        if (!channel->isEnabled) {
+            continue;
+        }
+        if (channel->ticksToStopBit == 0) {
+            if (!SPSCByteQueue_is_empty(channel->txQueue)) {
+                channel->ticksToStopBit = TICKS_PER_BYTE;
+            }
+        } else if (--channel->ticksToStopBit == 0) {
+            const char ch = SPSCByteQueue_pop(channel->txQueue);
+            if (txSink != 0) {
+                txSink(channelIndex, ch);
+            }
+        }
+    }
+}
+
+void HostHAL_setSerialTxSink (
+    HostHAL_SerialTxSink sink)
+{
+    txSink = sink;
+}
+
+void SoftwareSerialTx_Initialize (void)
+{
+    channels[0].txQueue = &txQueue0;
+    channels[1].txQueue = &txQueue1;
+    for (int channelIndex = 0; channelIndex < NUM_CHANNELS; ++channelIndex) {
+        channels[channelIndex].isEnabled = false;
+        channels[channelIndex].ticksToStopBit = 0;
+    }
+    SystemTime_registerForTickNotification(systemTimeTickTask);
+}
+
+void SoftwareSerialTx_open (
+    const uint8_t channelIndex,
+    const IOPortBitfield_PortSelection port,
+    const uint8_t pin)
+{
+    TxDescriptor *channel = &channels[channelIndex];
+    channel->isEnabled = false;
+    channel->ticksToStopBit = 0;
+    SPSCByteQueue_clear(channel->txQueue);
+}
+
+void SoftwareSerialTx_enable (
+    const uint8_t channelIndex)
+{
+    channels[channelIndex].isEnabled = true;
+}
+
+void SoftwareSerialTx_disable (
+    const uint8_t channelIndex)
+{
+    channels[channelIndex].isEnabled = false;
+}
+
+bool SoftwareSerialTx_isIdle (
+    const uint8_t channelIndex)
+{
+    TxDescriptor *channel = &channels[channelIndex];
+    return (channel->ticksToStopBit == 0) &&
+        SPSCByteQueue_is_empty(channel->txQueue);
+}
+
+uint16_t SoftwareSerialTx_availableSpace (
+    const uint8_t channelIndex)
+{
+    return SPSCByteQueue_spaceRemaining(channels[channelIndex].txQueue);
+}
+
+void SoftwareSerialTx_send (
+    const uint8_t channelIndex,
+    const char* text)
+{
+    TxDescriptor *channel = &channels[channelIndex];
+    if (channel->isEnabled) {
+        const size_t length = strlen(text);
+        SPSCByteQueue_pushBlock((const ByteQueueElement*)text,
+            (length > 255) ? 255 : length, channel->txQueue);
+    }
+}
+
+void SoftwareSerialTx_sendCS (
+    const uint8_t channelIndex,
+    const CharString_t* text)
+{
+    CharStringSpan_t textSpan;
+    CharStringSpan_init(text, &textSpan);
+    SoftwareSerialTx_sendCSS(channelIndex, &textSpan);
+}
+
+void SoftwareSerialTx_sendCSS (
+    const uint8_t channelIndex,
+    const CharStringSpan_t* text)
+{
+    TxDescriptor *channel = &channels[channelIndex];
+    if (channel->isEnabled) {
+        SPSCByteQueue_pushBlock(
+            (const ByteQueueElement*)CharStringSpan_begin(text),
+            CharStringSpan_length(text), channel->txQueue);
+    }
+}
+
+bool SoftwareSerialTx_sendP (
+    const uint8_t channelIndex,
+    PGM_P string)
+{
+    TxDescriptor *channel = &channels[channelIndex];
+    const size_t length = strlen_P(string);
+    if ((!channel->isEnabled) ||
+        (length > SPSCByteQueue_spaceRemaining(channel->txQueue))) {
+        return false;
+    }
+    SPSCByteQueue_pushBlock((const ByteQueueElement*)string, length,
+        channel->txQueue);
+    return true;
+}
+
+void SoftwareSerialTx_sendChar (
+    const uint8_t channelIndex,
+    const char ch)
+{
+    TxDescriptor *channel = &channels[channelIndex];
+    if (channel->isEnabled) {
+        SPSCByteQueue_push((ByteQueueElement)ch, channel->txQueue);
+    }
+}
+
+void SoftwareSerialTx_reportQueue (
+    const uint8_t channelIndex)
+{
+    SPSCByteQueue_reportStatistics(
+        (channelIndex == 0) ? PSTR("SSTX0") : PSTR("SSTX1"),
+        channels[channelIndex].txQueue);
+}
+
+//
+// software serial receiver. host programs push the received bytes into
+// its queue directly
+//
+SPSCByteQueue_define(64, rxQueue, static);
+
+SPSCByteQueue_t* SoftwareSerial_rx0Queue (void)
+{
+    return &rxQueue;
+}
+
+uint16_t SoftwareSerialRx0_framingErrors (void)
+{
+    return 0;
+}
+
+void SoftwareSerialRx0_reportQueue (
+    const uint8_t line)
+{
+    if (line == 0) {
+        SPSCByteQueue_reportStatistics(PSTR("SSRX0"), &rxQueue);
+    } else {
+        Console_printP(PSTR("SSRX0 fe:0"));
+    }
+}
+
+//
+// water level display. the application task is not built on the host,
+// only the settings that CommandProcessor changes
+//
+#if WATERLEVELDISPLAY_SESSION_ENABLED
+static bool persistentSession = false;
+#endif
+#if WATERLEVELDISPLAY_BINARY_TELEMETRY_ENABLED
+static bool binaryTelemetry = false;
+#endif
+#if SAMPLEHISTORY_ENABLED
+static bool historyUpload = false;
+#endif
+
+WaterLevelDisplayState WaterLevelDisplay_state (void)
+{
+    return wlds_waitingForNextConnectTime;
+}
+
+#if WATERLEVELDISPLAY_SESSION_ENABLED
+void WaterLevelDisplay_setPersistentSession (
+    const bool enabled)
+{
+    persistentSession = enabled;
+}
+
+bool WaterLevelDisplay_persistentSession (void)
+{
+    return persistentSession;
+}
+#endif
+
+#if WATERLEVELDISPLAY_BINARY_TELEMETRY_ENABLED
+void WaterLevelDisplay_setBinaryTelemetry (
+    const bool binary)
+{
+    binaryTelemetry = binary;
+}
+#endif
+
+#if SAMPLEHISTORY_ENABLED
+void WaterLevelDisplay_setHistoryUpload (
+    const bool upload)
+{
+    historyUpload = upload;
+}
+#endif
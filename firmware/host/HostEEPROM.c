@@ -0,0 +1,346 @@
+//
+//  Host EEPROM
+//
+//  Stands in for EEPROM_Util.c and EEPROMStorage.c on the host. EEMEM
+//  variables are ordinary variables here (see avr/eeprom.h), so the EEPROM
+//  functions read and write them directly. The settings are kept in RAM
+//  and start out with the values below.
+//
+#include "EEPROM_Util.h"
+#include "EEPROMStorage.h"
+
+//
+// EEPROM access
+//
+void EEPROM_write (
+    uint8_t* uiAddress,
+    const uint8_t ucData)
+{
+    *uiAddress = ucData;
+}
+
+uint8_t EEPROM_read (
+    const uint8_t* uiAddress)
+{
+    return *uiAddress;
+}
+
+void EEPROM_writeString (
+    char* uiAddress,
+    const int maxLength,
+    const CharStringSpan_t *string)
+{
+    int length = CharStringSpan_length(string);
+    if (length > (maxLength - 1)) {
+        length = maxLength - 1;
+    }
+    memcpy(uiAddress, CharStringSpan_begin(string), length);
+    uiAddress[length] = 0;
+}
+
+bool EEPROM_haveString (
+    const char* uiAddress)
+{
+    return *uiAddress != 0;
+}
+
+void EEPROM_readString (
+    const char* uiAddress,
+    CharString_t *string)
+{
+    CharString_append(uiAddress, string);
+}
+
+void EEPROM_writeWord (
+    uint16_t* uiAddress,
+    const uint16_t word)
+{
+    *uiAddress = word;
+}
+
+uint16_t EEPROM_readWord (
+    const uint16_t* uiAddress)
+{
+    return *uiAddress;
+}
+
+void EEPROM_writeLong (
+    uint32_t* uiAddress,
+    const uint32_t longword)
+{
+    *uiAddress = longword;
+}
+
+uint32_t EEPROM_readLong (
+    const uint32_t* uiAddress)
+{
+    return *uiAddress;
+}
+
+//
+// settings
+//
+static uint16_t unitID = 1;
+static uint32_t lastRebootTimeSec = 0;
+static uint16_t rebootInterval = 1440;
+static char PIN[8] = "";
+static int16_t tempCalOffset = 0;
+static int8_t utcOffset = 0;
+static uint16_t monitorTaskTimeout = 120;
+static bool notification = false;
+static uint8_t timeoutState = 0;
+static char APN[32] = "internet";
+static char username[16] = "";
+static char password[16] = "";
+static uint8_t cipqsend = 1;
+static uint16_t loggingUpdateInterval = 600;
+static uint16_t loggingUpdateDelay = 0;
+static uint8_t LCDMainsOnBrightness = 10;
+static uint8_t LCDMainsOffBrightness = 2;
+static bool ipConsoleEnabled = true;
+static char ipConsoleServerAddress[32] = "127.0.0.1";
+static uint16_t ipConsoleServerPort = 5000;
+
+void EEPROMStorage_Initialize (void)
+{
+}
+
+void EEPROMStorage_setUnitID (
+    const uint16_t id)
+{
+    unitID = id;
+}
+
+uint16_t EEPROMStorage_unitID (void)
+{
+    return unitID;
+}
+
+void EEPROMStorage_setLastRebootTimeSec (
+    const uint32_t sec)
+{
+    lastRebootTimeSec = sec;
+}
+
+uint32_t EEPROMStorage_lastRebootTimeSec (void)
+{
+    return lastRebootTimeSec;
+}
+
+void EEPROMStorage_setRebootInterval (
+    const uint16_t rebootMinutes)
+{
+    rebootInterval = rebootMinutes;
+}
+
+uint16_t EEPROMStorage_rebootInterval (void)
+{
+    return rebootInterval;
+}
+
+uint8_t EEPROMStorage_watchdogTimerCal (void)
+{
+    return 100;
+}
+
+void EEPROMStorage_setPIN (
+    const CharStringSpan_t *newPIN)
+{
+    EEPROM_writeString(PIN, sizeof(PIN), newPIN);
+}
+
+void EEPROMStorage_getPIN (
+    CharString_t *pin)
+{
+    CharString_append(PIN, pin);
+}
+
+void EEPROMStorage_setTempCalOffset (
+    const int16_t offset)
+{
+    tempCalOffset = offset;
+}
+
+int16_t EEPROMStorage_tempCalOffset (void)
+{
+    return tempCalOffset;
+}
+
+void EEPROMStorage_setUTCOffset(
+    const int8_t offset)
+{
+    utcOffset = offset;
+}
+
+int8_t EEPROMStorage_utcOffset (void)
+{
+    return utcOffset;
+}
+
+void EEPROMStorage_setMonitorTaskTimeout (
+    const uint16_t wlmTimeout)
+{
+    monitorTaskTimeout = wlmTimeout;
+}
+
+uint16_t EEPROMStorage_monitorTaskTimeout (void)
+{
+    return monitorTaskTimeout;
+}
+
+void EEPROMStorage_setNotification (
+    const bool onOff)
+{
+    notification = onOff;
+}
+
+bool EEPROMStorage_notificationEnabled (void)
+{
+    return notification;
+}
+
+void EEPROMStorage_setTimeoutState (
+    const uint8_t state)
+{
+    timeoutState = state;
+}
+
+uint8_t EEPROMStorage_timeoutState (void)
+{
+    return timeoutState;
+}
+
+void EEPROMStorage_setAPN (
+    const CharStringSpan_t *newAPN)
+{
+    EEPROM_writeString(APN, sizeof(APN), newAPN);
+}
+
+void EEPROMStorage_getAPN (
+    CharString_t *apn)
+{
+    CharString_append(APN, apn);
+}
+
+void EEPROMStorage_setUsername (
+    const CharStringSpan_t *usern)
+{
+    EEPROM_writeString(username, sizeof(username), usern);
+}
+
+bool EEPROMStorage_haveUsername (void)
+{
+    return username[0] != 0;
+}
+
+void EEPROMStorage_getUsername (
+    CharString_t *usern)
+{
+    CharString_append(username, usern);
+}
+
+void EEPROMStorage_setPassword (
+    const CharStringSpan_t *passw)
+{
+    EEPROM_writeString(password, sizeof(password), passw);
+}
+
+bool EEPROMStorage_havePassword (void)
+{
+    return password[0] != 0;
+}
+
+void EEPROMStorage_getPassword (
+    CharString_t *passw)
+{
+    CharString_append(password, passw);
+}
+
+void EEPROMStorage_setCipqsend (
+    const uint8_t qsend)
+{
+    cipqsend = qsend;
+}
+
+uint8_t EEPROMStorage_cipqsend (void)
+{
+    return cipqsend;
+}
+
+void EEPROMStorage_setLoggingUpdateInterval (
+    const uint16_t updateInterval)
+{
+    loggingUpdateInterval = updateInterval;
+}
+
+uint16_t EEPROMStorage_LoggingUpdateInterval (void)
+{
+    return loggingUpdateInterval;
+}
+
+void EEPROMStorage_setLoggingUpdateDelay (
+    const uint16_t updateDelay)
+{
+    loggingUpdateDelay = updateDelay;
+}
+
+uint16_t EEPROMStorage_LoggingUpdateDelay (void)
+{
+    return loggingUpdateDelay;
+}
+
+void EEPROMStorage_setLCDMainsOnBrightness (
+    const uint8_t mainsOnBrightness)
+{
+    LCDMainsOnBrightness = mainsOnBrightness;
+}
+
+uint8_t EEPROMStorage_LCDMainsOnBrightness (void)
+{
+    return LCDMainsOnBrightness;
+}
+
+void EEPROMStorage_setLCDMainsOffBrightness (
+    const uint8_t mainsOffBrightness)
+{
+    LCDMainsOffBrightness = mainsOffBrightness;
+}
+
+uint8_t EEPROMStorage_LCDMainsOffBrightness (void)
+{
+    return LCDMainsOffBrightness;
+}
+
+void EEPROMStorage_setIPConsoleEnabled (
+    const bool enabled)
+{
+    ipConsoleEnabled = enabled;
+}
+
+bool EEPROMStorage_ipConsoleEnabled (void)
+{
+    return ipConsoleEnabled;
+}
+
+void EEPROMStorage_setIPConsoleServerAddress (
+    const CharStringSpan_t* server)
+{
+    EEPROM_writeString(ipConsoleServerAddress, sizeof(ipConsoleServerAddress), server);
+}
+
+void EEPROMStorage_getIPConsoleServerAddress (
+    CharString_t *server)
+{
+    CharString_append(ipConsoleServerAddress, server);
+}
+
+void EEPROMStorage_setIPConsoleServerPort (
+    const uint16_t port)
+{
+    ipConsoleServerPort = port;
+}
+
+uint16_t EEPROMStorage_ipConsoleServerPort (void)
+{
+    return ipConsoleServerPort;
+}
@@ -0,0 +1,138 @@
+//
+//  Host hardware abstraction
+//
+//  Stands in for the registers, the timer interrupt and the USB console
+//  when the firmware modules are built for the host (see makefile).
+//  Console output goes to stdout.
+//
+#include <stdio.h>
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "HostHAL.h"
+#include "Console.h"
+#include "USBTerminal.h"
+
+// registers. writes have no effect on the host
+volatile uint8_t SREG;
+volatile uint8_t PORTB;
+volatile uint8_t PORTC;
+volatile uint8_t PORTD;
+volatile uint8_t PORTF;
+volatile uint8_t DDRB;
+volatile uint8_t DDRD;
+volatile uint8_t DDRF;
+volatile uint8_t PIND;
+volatile uint8_t TCCR3B;
+volatile uint16_t OCR3A;
+volatile uint16_t TCNT3;
+volatile uint8_t TIFR3;
+volatile uint8_t TIMSK3;
+volatile uint8_t WDTCSR;
+volatile uint8_t SPCR;
+
+static bool consoleQuiet = false;
+
+// SPI. a write to SPDR can't be told from a read, so every access marks
+// a byte as pending and it is sent on the next access
+static volatile uint8_t spiData;
+static volatile uint8_t spiStatus;
+static bool spiBytePending = false;
+static HostHAL_SPISink spiSink = NULL;
+
+void HostHAL_runTicks (
+    const uint32_t ticks)
+{
+    for (uint32_t t = 0; t < ticks; ++t) {
+        TIMER3_COMPA_vect();
+    }
+}
+
+void HostHAL_setConsoleQuiet (
+    const bool quiet)
+{
+    consoleQuiet = quiet;
+}
+
+void HostHAL_setSPISink (
+    HostHAL_SPISink sink)
+{
+    spiSink = sink;
+}
+
+static void sendPendingSPIByte (void)
+{
+    if (spiBytePending) {
+        spiBytePending = false;
+        if (spiSink != NULL) {
+            spiSink(spiData);
+        }
+    }
+}
+
+volatile uint8_t* HostHAL_spiDataRegister (void)
+{
+    sendPendingSPIByte();
+    spiBytePending = true;
+    return &spiData;
+}
+
+volatile uint8_t* HostHAL_spiStatusRegister (void)
+{
+    sendPendingSPIByte();
+    spiStatus |= (1 << SPIF);
+    return &spiStatus;
+}
+
+void Console_print (
+    const char* text)
+{
+    if (!consoleQuiet) {
+        puts(text);
+    }
+}
+
+void Console_printP (
+    PGM_P text)
+{
+    if (!consoleQuiet) {
+        puts(text);
+    }
+}
+
+void Console_printCS (
+    const CharString_t *text)
+{
+    if (!consoleQuiet) {
+        printf("%.*s\n", (int)CharString_length(text), CharString_begin(text));
+    }
+}
+
+void Console_printCSS (
+    const CharStringSpan_t *text)
+{
+    if (!consoleQuiet) {
+        printf("%.*s\n", (int)CharStringSpan_length(text), CharStringSpan_begin(text));
+    }
+}
+
+//
+// USB terminal. there is no USB host, so its queues only exist to be
+// reported
+//
+SPSCByteQueue_define(256, ToUSB_Buffer,)
+SPSCByteQueue_define(16, FromUSB_Buffer,)
+
+uint16_t USBTerminal_takeBytesSent (void)
+{
+    return 0;
+}
+
+void USBTerminal_reportQueue (
+    const uint8_t line)
+{
+    if (line == 0) {
+        SPSCByteQueue_reportStatistics(PSTR("USBTX"), &ToUSB_Buffer);
+    } else {
+        SPSCByteQueue_reportStatistics(PSTR("USBRX"), &FromUSB_Buffer);
+    }
+}
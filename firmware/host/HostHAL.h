@@ -0,0 +1,56 @@
+//
+//  Host hardware abstraction
+//
+//  What it does:
+//    Controls the stand-ins for the hardware when the firmware modules are
+//    built for the host (see makefile). Time only advances when a host
+//    program runs timer ticks, so runs are repeatable and independent of
+//    the speed of the host.
+//
+//  How to use it:
+//    Call HostHAL_runTicks to let time pass. It runs the Timer3 compare
+//    interrupt of SystemTime once per tick, which also runs the tick
+//    notifications (e.g. the serial transmitter stand-in).
+//    The other functions inspect or drive the stand-ins for the display,
+//    the power monitor and the SIM800 serial link.
+//
+#ifndef HOSTHAL_H
+#define HOSTHAL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "TFT_HXD8357D.h"
+
+// runs the given number of SystemTime ticks
+extern void HostHAL_runTicks (
+    const uint32_t ticks);
+
+// when quiet, console output is discarded instead of going to stdout
+extern void HostHAL_setConsoleQuiet (
+    const bool quiet);
+
+// the sources registered with TFT_HXD8357D, or NULL if none
+extern TFT_HXD8357D_RectangleSource HostHAL_rectangleSource (void);
+extern TFT_HXD8357D_TextSource HostHAL_textSource (void);
+
+// sets what PowerMonitor reports
+extern void HostHAL_setPowerState (
+    const bool mainsOn,
+    const bool pumpOn);
+
+// receives each byte sent on a SoftwareSerialTx channel, at the time its
+// stop bit would have been sent (one bit per SystemTime tick)
+typedef void (*HostHAL_SerialTxSink)(
+    const uint8_t channelIndex,
+    const char ch);
+extern void HostHAL_setSerialTxSink (
+    HostHAL_SerialTxSink sink);
+
+// receives each byte sent on the SPI port (see avr/io.h). The TFT
+// display's data/command pin is PORTB bit PB7, low for a command byte
+typedef void (*HostHAL_SPISink)(
+    const uint8_t byte);
+extern void HostHAL_setSPISink (
+    HostHAL_SPISink sink);
+
+#endif  // HOSTHAL_H
@@ -0,0 +1,40 @@
+//
+//  Host stand-in for the TFT display driver
+//
+//  The display sources are only recorded, for host programs to draw from
+//  (see HostHAL.h). Kept apart from HostDrivers.c so that a host program
+//  can link the real driver, TFT_HXD8357D.c, against the SPI model in
+//  HostHAL.c instead (see TFTBenchmark.c).
+//
+#include "HostHAL.h"
+#include "TFT_HXD8357D.h"
+
+static TFT_HXD8357D_RectangleSource rectangleSource;
+static TFT_HXD8357D_TextSource textSource;
+
+void TFT_HXD8357D_setRectangleSource (
+    TFT_HXD8357D_RectangleSource source)
+{
+    rectangleSource = source;
+}
+
+void TFT_HXD8357D_setTextSource (
+    TFT_HXD8357D_TextSource source)
+{
+    textSource = source;
+}
+
+void TFT_HXD8357D_setBacklightBrightness (
+    const uint8_t brightness)
+{
+}
+
+TFT_HXD8357D_RectangleSource HostHAL_rectangleSource (void)
+{
+    return rectangleSource;
+}
+
+TFT_HXD8357D_TextSource HostHAL_textSource (void)
+{
+    return textSource;
+}
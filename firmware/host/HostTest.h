@@ -0,0 +1,46 @@
+//
+//  Host test checks
+//
+//  What it does:
+//    The checks used by the host test programs. A failed check prints the
+//    condition and where it is, and is counted; the program reports the
+//    count and exits with a failure status if there were any.
+//
+//  How to use it:
+//    HostTest_check(condition) in the tests, and
+//    return HostTest_finish("name") at the end of main.
+//
+#ifndef HOSTTEST_H
+#define HOSTTEST_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+static unsigned HostTest_checks;
+static unsigned HostTest_failures;
+
+#define HostTest_check(condition) \
+    HostTest_checkAt((condition), #condition, __FILE__, __LINE__)
+
+static inline bool HostTest_checkAt (
+    const bool passed,
+    const char* condition,
+    const char* file,
+    const int line)
+{
+    ++HostTest_checks;
+    if (!passed) {
+        ++HostTest_failures;
+        printf("%s:%d: check failed: %s\n", file, line, condition);
+    }
+    return passed;
+}
+
+static inline int HostTest_finish (
+    const char* name)
+{
+    printf("%s: %u checks, %u failed\n", name, HostTest_checks, HostTest_failures);
+    return (HostTest_failures == 0) ? 0 : 1;
+}
+
+#endif  // HOSTTEST_H
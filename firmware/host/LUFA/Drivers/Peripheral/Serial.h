@@ -0,0 +1,7 @@
+//
+//  Host shim for LUFA/Drivers/Peripheral/Serial.h
+//
+#ifndef HOST_LUFA_SERIAL_H
+#define HOST_LUFA_SERIAL_H
+
+#endif  // HOST_LUFA_SERIAL_H
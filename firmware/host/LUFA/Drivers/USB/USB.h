@@ -0,0 +1,30 @@
+//
+//  Host shim for LUFA/Drivers/USB/USB.h
+//
+//  Only what the USBTerminal and Descriptors headers need to compile.
+//  There is no USB on the host; console output goes to stdout (see
+//  HostHAL.c)
+//
+#ifndef HOST_LUFA_USB_H
+#define HOST_LUFA_USB_H
+
+#include <stdint.h>
+
+#define ENDPOINT_DIR_IN  0x80
+#define ENDPOINT_DIR_OUT 0x00
+
+#define ATTR_WARN_UNUSED_RESULT
+#define ATTR_NON_NULL_PTR_ARG(arg)
+
+typedef uint8_t USB_Descriptor_Configuration_Header_t;
+typedef uint8_t USB_Descriptor_Interface_t;
+typedef uint8_t USB_CDC_Descriptor_FunctionalHeader_t;
+typedef uint8_t USB_CDC_Descriptor_FunctionalACM_t;
+typedef uint8_t USB_CDC_Descriptor_FunctionalUnion_t;
+typedef uint8_t USB_Descriptor_Endpoint_t;
+
+typedef struct {
+    uint8_t unused;
+} USB_ClassInfo_CDC_Device_t;
+
+#endif  // HOST_LUFA_USB_H
@@ -0,0 +1,7 @@
+//
+//  Host shim for LUFA/Version.h
+//
+#ifndef HOST_LUFA_VERSION_H
+#define HOST_LUFA_VERSION_H
+
+#endif  // HOST_LUFA_VERSION_H
@@ -0,0 +1,284 @@
+//
+//  SIM800 simulation
+//
+//  What it does:
+//    Runs SIM800.c, CellularComm_SIM800.c, CellularTCPIP_SIM800.c and
+//    TCPIPConsole.c against the SIM800 simulator (see SIM800Simulator.h)
+//    through power up, registration, connecting to the host, a series of
+//    sample sends, disconnecting and power down, and reports how long
+//    connecting and each send took in simulated time. Sends are text
+//    records terminated by Ctrl-Z, as WaterLevelDisplay sends them.
+//    There are two scripts: a clean dialog, and the same dialog with
+//    faults the firmware has to recover from.
+//    Built as SIM800SimulationNoFastSend, CellularTCPIP is built with
+//    FAST_SEND_ENABLED 0, so the send times of the two can be compared.
+//    The exit status is nonzero if the run didn't finish or the firmware
+//    sent a command the script doesn't cover.
+//
+//  How to use it:
+//    "make sim", or run ./SIM800Simulation [-f] [-t] [-l percent] [-n sends]
+//      -f  use the script with faults
+//      -t  print the dialog
+//      -l  scale the latencies of the script (default 100)
+//      -n  number of sends (default 10)
+//
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "HostHAL.h"
+#include "SIM800Simulator.h"
+#include "SystemTime.h"
+#include "SoftwareSerialTx.h"
+#include "SIM800.h"
+#include "CellularComm_SIM800.h"
+#include "CellularTCPIP_SIM800.h"
+#include "TCPIPConsole.h"
+#include "CharString.h"
+
+// simulated time between the end of one send and the next
+#define SEND_INTERVAL (5 * SYSTEMTIME_TICKS_PER_SECOND)
+// gives up if the run takes longer than this in simulated time
+#define TIME_LIMIT (30L * 60 * SYSTEMTIME_TICKS_PER_SECOND)
+
+#define OK "\r\nOK\r\n"
+
+// a unit in the field on a good day. latencies are in 1/100 s
+static const SIM800Simulator_Exchange cleanScript[] = {
+    // power up
+    {NULL,              0, 0, 150, "\r\nRDY\r\n",
+                                   200, "\r\n+CFUN: 1\r\n\r\n+CPIN: READY\r\n"
+                                        "\r\nCall Ready\r\n\r\nSMS Ready\r\n"},
+    {"ATE0",            0, 0,   2, OK},
+    {"AT+CMGF=1",       0, 0,   2, OK},
+    {"AT+CIPQSEND=",    0, 0,   2, OK},
+    {"AT+CIPHEAD=1",    0, 0,   2, OK},
+    {"AT+CBC",          0, 0,   2, "\r\n+CBC: 0,86,4071\r\n" OK},
+    // still searching for the network on the first query
+    {"AT+CREG?",        0, 1,   2, "\r\n+CREG: 0,2\r\n" OK},
+    {"AT+CREG?",        1, 0,   2, "\r\n+CREG: 0,1\r\n" OK},
+    {"AT+CSQ",          0, 0,   2, "\r\n+CSQ: 14,0\r\n" OK},
+    {"AT+CCLK?",        0, 0,   2, "\r\n+CCLK: \"26/10/16,08:30:02-16\"\r\n" OK},
+    {"AT+CGATT?",       0, 0,   2, "\r\n+CGATT: 1\r\n" OK},
+    // bringing up GPRS, then connected from there on
+    {"AT+CIPSTATUS",    0, 1,   2, OK "\r\nSTATE: IP INITIAL\r\n"},
+    {"AT+CIPSTATUS",    1, 1,   2, OK "\r\nSTATE: IP START\r\n"},
+    {"AT+CIPSTATUS",    2, 1,   2, OK "\r\nSTATE: IP GPRSACT\r\n"},
+    {"AT+CIPSTATUS",    3, 1,   2, OK "\r\nSTATE: IP STATUS\r\n"},
+    {"AT+CIPSTATUS",    4, 0,   2, OK "\r\nSTATE: CONNECT OK\r\n"},
+    {"AT+CSTT=",        0, 0,   2, OK},
+    {"AT+CIICR",        0, 0, 150, OK},
+    {"AT+CIFSR",        0, 0,  10, "\r\n10.170.34.5\r\n"},
+    {"AT+CIPSTART=",    0, 0,   2, OK, 120, "\r\nCONNECT OK\r\n"},
+    {"AT+CIPACK",       0, 0,   2, "\r\n+CIPACK: 120,120,0\r\n" OK},
+    {"AT+CIPSEND",      0, 0,   2, "\r\n> ", 30, "\r\nDATA ACCEPT:%u\r\n"},
+    {"AT+CIPCLOSE",     0, 0,  10, "\r\nCLOSE OK\r\n"},
+    {"AT+CIPSHUT",      0, 0,  50, "\r\nSHUT OK\r\n"},
+};
+
+// put ahead of the clean script, so they take the occurrences they name
+static const SIM800Simulator_Exchange faults[] = {
+    // GPRS isn't attached on the first query
+    {"AT+CGATT?",       0, 1,   2, "\r\nERROR\r\n"},
+    // the first connection attempt fails, which leaves the connection
+    // closed for the next
+    {"AT+CIPSTART=",    0, 1,   2, OK, 300, "\r\nCONNECT FAIL\r\n"},
+    {"AT+CIPSTATUS",    4, 1,   2, OK "\r\nSTATE: TCP CLOSED\r\n"},
+    // the connection has gone by the third send
+    {"AT+CIPSEND",      2, 1,   2, "\r\nERROR\r\n"},
+    // the DATA ACCEPT of the sixth is lost
+    {"AT+CIPSEND",      5, 1,   2, "\r\n> ", 0, NULL},
+};
+
+#define NUM_CLEAN_EXCHANGES (sizeof(cleanScript) / sizeof(cleanScript[0]))
+#define NUM_FAULTS (sizeof(faults) / sizeof(faults[0]))
+
+static SIM800Simulator_Exchange faultScript[NUM_FAULTS + NUM_CLEAN_EXCHANGES];
+
+// durations, in ticks
+typedef struct Durations_struct {
+    uint16_t count;
+    uint16_t failures;
+    uint32_t first;
+    uint32_t min;
+    uint32_t max;
+    uint32_t total;
+} Durations;
+
+static uint32_t ticks;
+static CellularTCPIPConnectionStatus connectionStatus;
+static uint32_t connectStartTicks;
+static Durations connects;
+static uint32_t sendStartTicks;
+static Durations sends;
+static bool sendInProgress;
+static uint32_t nextSendTicks;
+
+static void recordDuration (
+    const uint32_t duration,
+    const bool successful,
+    Durations *durations)
+{
+    if (durations->count == 0) {
+        durations->first = duration;
+        durations->min = duration;
+    }
+    ++durations->count;
+    if (!successful) {
+        ++durations->failures;
+    }
+    if (duration < durations->min) {
+        durations->min = duration;
+    }
+    if (duration > durations->max) {
+        durations->max = duration;
+    }
+    durations->total += duration;
+}
+
+static double seconds (
+    const uint32_t t)
+{
+    return ((double)t) / SYSTEMTIME_TICKS_PER_SECOND;
+}
+
+static void reportDurations (
+    const char* name,
+    const Durations *durations)
+{
+    printf("  %-8s n:%u f:%u  first %.2f  min %.2f  avg %.2f  max %.2f s\n",
+        name, durations->count, durations->failures,
+        seconds(durations->first), seconds(durations->min),
+        seconds((durations->count != 0) ? (durations->total / durations->count) : 0),
+        seconds(durations->max));
+}
+
+static void watchConnection (void)
+{
+    const CellularTCPIPConnectionStatus status = CellularTCPIP_connectionStatus();
+    if (status != connectionStatus) {
+        if (status == cs_connecting) {
+            connectStartTicks = ticks;
+        } else if (connectionStatus == cs_connecting) {
+            recordDuration(ticks - connectStartTicks,
+                status == cs_connected, &connects);
+        }
+        connectionStatus = status;
+    }
+}
+
+static bool sampleSender (void)
+{
+    CharString_define(40, sample);
+    CharString_copyP(PSTR("I1L57V1B4071R1Q14M1P0T0C600;Z\n"), &sample);
+    if (CellularTCPIP_availableSpaceForWriteData() < CharString_length(&sample)) {
+        return false;
+    }
+    CellularTCPIP_writeDataCS(&sample);
+    return true;
+}
+
+static void sendCompleted (
+    const bool success)
+{
+    recordDuration(ticks - sendStartTicks, success, &sends);
+    sendInProgress = false;
+    nextSendTicks = ticks + SEND_INTERVAL;
+}
+
+static void step (void)
+{
+    HostHAL_runTicks(1);
+    ++ticks;
+    SIM800_task();
+    CellularComm_task();
+    TCPIPConsole_task();
+    watchConnection();
+}
+
+int main (
+    int argc,
+    char** argv)
+{
+    bool withFaults = false;
+    bool trace = false;
+    uint16_t latencyPercent = 100;
+    uint16_t numSends = 10;
+    int opt;
+    while ((opt = getopt(argc, argv, "ftl:n:")) != -1) {
+        switch (opt) {
+            case 'f' : withFaults = true;                   break;
+            case 't' : trace = true;                        break;
+            case 'l' : latencyPercent = atoi(optarg);       break;
+            case 'n' : numSends = atoi(optarg);             break;
+            default :
+                fprintf(stderr,
+                    "usage: %s [-f] [-t] [-l percent] [-n sends]\n", argv[0]);
+                return 2;
+        }
+    }
+
+    HostHAL_setConsoleQuiet(true);
+    SystemTime_Initialize();
+    SoftwareSerialTx_Initialize();
+    if (withFaults) {
+        memcpy(faultScript, faults, sizeof(faults));
+        memcpy(&faultScript[NUM_FAULTS], cleanScript, sizeof(cleanScript));
+        SIM800Simulator_Initialize(faultScript, NUM_FAULTS + NUM_CLEAN_EXCHANGES);
+    } else {
+        SIM800Simulator_Initialize(cleanScript, NUM_CLEAN_EXCHANGES);
+    }
+    SIM800Simulator_setLatencyPercent(latencyPercent);
+    SIM800Simulator_setTrace(trace);
+    CellularComm_Initialize();
+    TCPIPConsole_Initialize();
+    connectionStatus = CellularTCPIP_connectionStatus();
+    CellularComm_Enable();
+
+    // power up, connect and send
+    uint32_t registeredTicks = 0;
+    while ((sends.count < numSends) && (ticks < TIME_LIMIT)) {
+        step();
+        if ((registeredTicks == 0) && CellularComm_isRegistered()) {
+            registeredTicks = ticks;
+        }
+        if ((!sendInProgress) && (ticks >= nextSendTicks) &&
+            TCPIPConsole_readyToSend()) {
+            sendStartTicks = ticks;
+            sendInProgress = true;
+            TCPIPConsole_sendData(sampleSender, 0, sendCompleted);
+        }
+    }
+
+    // disconnect and power down
+    const uint32_t powerDownStartTicks = ticks;
+    CellularComm_Disable();
+    while ((CellularComm_isEnabled() || SIM800Simulator_isPoweredOn()) &&
+           (ticks < TIME_LIMIT)) {
+        step();
+    }
+    const bool finished = (ticks < TIME_LIMIT);
+
+    const SIM800Simulator_Statistics *simStats = SIM800Simulator_statistics();
+    printf("SIM800 simulation: %s script, latency %u%%, fast send %s\n",
+        withFaults ? "faults" : "clean", latencyPercent,
+        FAST_SEND_ENABLED ? "on" : "off");
+    printf("  registered after %.2f s\n", seconds(registeredTicks));
+    reportDurations("connect", &connects);
+    reportDurations("send", &sends);
+    printf("  disconnect and power down %.2f s\n",
+        seconds(ticks - powerDownStartTicks));
+    printf("  commands %u, unscripted %u, data bytes %u, reply bytes %u, "
+        "rx overruns %u\n",
+        simStats->commands, simStats->unscriptedCommands,
+        (unsigned)simStats->dataBytes, (unsigned)simStats->replyBytes,
+        simStats->rxOverruns);
+    // the firmware's own view, for comparison
+    HostHAL_setConsoleQuiet(false);
+    CellularTCPIP_reportStatistics();
+    if (!finished) {
+        printf("did not finish in %.0f s\n", seconds(TIME_LIMIT));
+    }
+
+    return (finished && (simStats->unscriptedCommands == 0)) ? 0 : 1;
+}
@@ -0,0 +1,378 @@
+//
+//  SIM800 simulator
+//
+//  Replies are queued with the time they are due, and go out one at a
+//  time, a byte per character time, in order of that time. Commands are
+//  only taken while the module is powered up.
+//
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <avr/io.h>
+#include "SIM800Simulator.h"
+#include "HostHAL.h"
+#include "SystemTime.h"
+#include "SPSCByteQueue.h"
+#include "SoftwareSerialRx0.h"
+
+// as on the board: the power key is PF1, driven low by making it an
+// output, and toggles the power when held for a second
+#define POWER_KEY_DIR DDRF
+#define POWER_KEY_PIN PF1
+#define POWER_KEY_TICKS SYSTEMTIME_TICKS_PER_SECOND
+
+// a start bit, 8 data bits and a stop bit, one bit per tick, as
+// SoftwareSerialTx sends
+#define TICKS_PER_BYTE 10
+
+#define MAX_EXCHANGES 48
+#define MAX_PENDING_REPLIES 8
+#define MAX_REPLY_LENGTH 200
+#define MAX_COMMAND_LENGTH 80
+
+#define CTRL_Z 26
+
+typedef struct PendingReply_struct {
+    bool isPending;
+    uint32_t dueTime;   // ticks
+    uint32_t sequence;  // order of queueing, for replies due together
+    char text[MAX_REPLY_LENGTH];
+} PendingReply;
+
+static const SIM800Simulator_Exchange* script;
+static uint8_t scriptLength;
+static uint8_t occurrences[MAX_EXCHANGES];
+static uint16_t latencyPercent;
+static bool tracing;
+static SIM800Simulator_Statistics statistics;
+
+static uint32_t now;    // ticks since SIM800Simulator_Initialize
+static bool poweredOn;
+static uint32_t powerKeyTicks;
+static bool echo;
+
+// command being received
+static char commandLine[MAX_COMMAND_LENGTH + 1];
+static uint8_t commandLength;
+static bool takingData;
+static uint16_t dataExpected;   // 0 if terminated by Ctrl-Z
+static uint16_t dataTaken;
+static const SIM800Simulator_Exchange* dataExchange;
+
+// replies
+static PendingReply pendingReplies[MAX_PENDING_REPLIES];
+static uint32_t nextSequence;
+static char output[MAX_REPLY_LENGTH];
+static uint16_t outputLength;
+static uint16_t outputPosition;
+static uint8_t ticksToNextByte;
+
+static void printTime (void)
+{
+    printf("[%9.3f] ", ((double)now) / SYSTEMTIME_TICKS_PER_SECOND);
+}
+
+// prints each nonempty line of the reply
+static void traceReply (
+    const char* reply)
+{
+    const char* lineStart = reply;
+    while (*lineStart != 0) {
+        const size_t lineLength = strcspn(lineStart, "\r\n");
+        if (lineLength != 0) {
+            printTime();
+            printf("< %.*s\n", (int)lineLength, lineStart);
+        }
+        lineStart += lineLength;
+        if (*lineStart != 0) {
+            ++lineStart;
+        }
+    }
+}
+
+static uint32_t ticksFromHundredths (
+    const uint16_t hundredths)
+{
+    return (((uint32_t)hundredths) * latencyPercent *
+            (SYSTEMTIME_TICKS_PER_SECOND / 100)) / 100;
+}
+
+static void queueReply (
+    const char* reply,
+    const uint32_t delay,
+    const uint16_t dataCount)
+{
+    if (reply == NULL) {
+        return;
+    }
+    for (int r = 0; r < MAX_PENDING_REPLIES; ++r) {
+        PendingReply *pending = &pendingReplies[r];
+        if (!pending->isPending) {
+            pending->isPending = true;
+            pending->dueTime = now + delay;
+            pending->sequence = nextSequence++;
+            snprintf(pending->text, sizeof(pending->text), reply, dataCount);
+            return;
+        }
+    }
+    printf("SIM800Simulator: too many pending replies\n");
+}
+
+static void clearReplies (void)
+{
+    for (int r = 0; r < MAX_PENDING_REPLIES; ++r) {
+        pendingReplies[r].isPending = false;
+    }
+    outputLength = 0;
+    outputPosition = 0;
+}
+
+static const SIM800Simulator_Exchange* findExchange (
+    const char* line)
+{
+    const SIM800Simulator_Exchange* found = NULL;
+    for (uint8_t e = 0; e < scriptLength; ++e) {
+        const SIM800Simulator_Exchange* exchange = &script[e];
+        const bool matches = (line == NULL)
+            ? (exchange->command == NULL)
+            : ((exchange->command != NULL) &&
+               (strncmp(line, exchange->command, strlen(exchange->command)) == 0));
+        if (matches) {
+            // every exchange for the command counts its occurrences, so
+            // that they agree on which occurrence this is
+            const uint8_t occurrence = occurrences[e];
+            if (occurrences[e] < 255) {
+                ++occurrences[e];
+            }
+            if ((found == NULL) &&
+                (occurrence >= exchange->first) &&
+                ((exchange->count == 0) ||
+                 (occurrence < (exchange->first + exchange->count)))) {
+                found = exchange;
+            }
+        }
+    }
+    return found;
+}
+
+static bool endsWithPrompt (
+    const char* reply)
+{
+    const size_t length = strlen(reply);
+    return (length >= 2) && (strcmp(reply + (length - 2), "> ") == 0);
+}
+
+static void runExchange (
+    const SIM800Simulator_Exchange* exchange)
+{
+    if (exchange->reply == NULL) {
+        // lost
+        return;
+    }
+    const uint32_t replyDelay = ticksFromHundredths(exchange->latency);
+    queueReply(exchange->reply, replyDelay, 0);
+    if (endsWithPrompt(exchange->reply)) {
+        const char* equals = strchr(commandLine, '=');
+        takingData = true;
+        dataExpected = (equals != NULL) ? atoi(equals + 1) : 0;
+        dataTaken = 0;
+        dataExchange = exchange;
+    } else {
+        queueReply(exchange->laterReply,
+            replyDelay + ticksFromHundredths(exchange->laterLatency), 0);
+    }
+}
+
+static void processCommand (void)
+{
+    commandLine[commandLength] = 0;
+    if (commandLength == 0) {
+        return;
+    }
+    ++statistics.commands;
+    if (tracing) {
+        printTime();
+        printf("> %s\n", commandLine);
+    }
+
+    if (echo) {
+        char echoLine[MAX_COMMAND_LENGTH + 2];
+        snprintf(echoLine, sizeof(echoLine), "%s\r", commandLine);
+        queueReply(echoLine, 0, 0);
+    }
+    if (strncmp(commandLine, "ATE0", 4) == 0) {
+        echo = false;
+    } else if (strncmp(commandLine, "ATE1", 4) == 0) {
+        echo = true;
+    }
+
+    const SIM800Simulator_Exchange* exchange = findExchange(commandLine);
+    if (exchange != NULL) {
+        runExchange(exchange);
+    } else {
+        ++statistics.unscriptedCommands;
+        printf("SIM800Simulator: no exchange for \"%s\"\n", commandLine);
+        queueReply("\r\nERROR\r\n", ticksFromHundredths(1), 0);
+    }
+}
+
+static void takeDataByte (
+    const char ch)
+{
+    const bool terminated = (dataExpected == 0) && (ch == CTRL_Z);
+    if (!terminated) {
+        ++dataTaken;
+        ++statistics.dataBytes;
+    }
+    if (terminated || (dataTaken == dataExpected)) {
+        takingData = false;
+        if (tracing) {
+            printTime();
+            printf("> (%u bytes of data)\n", dataTaken);
+        }
+        queueReply(dataExchange->laterReply,
+            ticksFromHundredths(dataExchange->laterLatency), dataTaken);
+    }
+}
+
+static void receiveByte (
+    const uint8_t channelIndex,
+    const char ch)
+{
+    if ((channelIndex != 0) || !poweredOn) {
+        return;
+    }
+    if (takingData) {
+        takeDataByte(ch);
+    } else if (ch == '\r') {
+        processCommand();
+        commandLength = 0;
+    } else if ((ch != '\n') && (commandLength < MAX_COMMAND_LENGTH)) {
+        commandLine[commandLength++] = ch;
+    }
+}
+
+static void togglePower (void)
+{
+    if (tracing) {
+        printTime();
+        printf("power %s\n", poweredOn ? "down" : "up");
+    }
+    commandLength = 0;
+    takingData = false;
+    if (poweredOn) {
+        poweredOn = false;
+        clearReplies();
+        queueReply("\r\nNORMAL POWER DOWN\r\n", 0, 0);
+    } else {
+        poweredOn = true;
+        echo = true;
+        const SIM800Simulator_Exchange* exchange = findExchange(NULL);
+        if (exchange != NULL) {
+            runExchange(exchange);
+        }
+    }
+}
+
+static void watchPowerKey (void)
+{
+    if ((POWER_KEY_DIR & (1 << POWER_KEY_PIN)) != 0) {
+        if ((powerKeyTicks < POWER_KEY_TICKS) &&
+            (++powerKeyTicks == POWER_KEY_TICKS)) {
+            togglePower();
+        }
+    } else {
+        powerKeyTicks = 0;
+    }
+}
+
+static void sendReplyBytes (void)
+{
+    if (outputPosition == outputLength) {
+        // start the earliest reply that is due
+        PendingReply *next = NULL;
+        for (int r = 0; r < MAX_PENDING_REPLIES; ++r) {
+            PendingReply *pending = &pendingReplies[r];
+            if (pending->isPending && (pending->dueTime <= now) &&
+                ((next == NULL) ||
+                 (pending->dueTime < next->dueTime) ||
+                 ((pending->dueTime == next->dueTime) &&
+                  (pending->sequence < next->sequence)))) {
+                next = pending;
+            }
+        }
+        if (next == NULL) {
+            return;
+        }
+        strcpy(output, next->text);
+        outputLength = strlen(output);
+        outputPosition = 0;
+        ticksToNextByte = TICKS_PER_BYTE;
+        next->isPending = false;
+        if (tracing) {
+            traceReply(output);
+        }
+    }
+    if ((outputPosition < outputLength) && (--ticksToNextByte == 0)) {
+        if (!SPSCByteQueue_push(
+                (ByteQueueElement)output[outputPosition],
+                SoftwareSerial_rx0Queue())) {
+            ++statistics.rxOverruns;
+        }
+        ++statistics.replyBytes;
+        ++outputPosition;
+        ticksToNextByte = TICKS_PER_BYTE;
+    }
+}
+
+static void systemTimeTickTask (void)
+{
+    ++now;
+    watchPowerKey();
+    sendReplyBytes();
+}
+
+void SIM800Simulator_Initialize (
+    const SIM800Simulator_Exchange* exchanges,
+    const uint8_t numExchanges)
+{
+    script = exchanges;
+    scriptLength = (numExchanges > MAX_EXCHANGES) ? MAX_EXCHANGES : numExchanges;
+    memset(occurrences, 0, sizeof(occurrences));
+    latencyPercent = 100;
+    tracing = false;
+    memset(&statistics, 0, sizeof(statistics));
+    now = 0;
+    poweredOn = false;
+    powerKeyTicks = 0;
+    echo = true;
+    commandLength = 0;
+    takingData = false;
+    clearReplies();
+    nextSequence = 0;
+
+    HostHAL_setSerialTxSink(receiveByte);
+    SystemTime_registerForTickNotification(systemTimeTickTask);
+}
+
+void SIM800Simulator_setLatencyPercent (
+    const uint16_t percent)
+{
+    latencyPercent = percent;
+}
+
+void SIM800Simulator_setTrace (
+    const bool trace)
+{
+    tracing = trace;
+}
+
+bool SIM800Simulator_isPoweredOn (void)
+{
+    return poweredOn;
+}
+
+const SIM800Simulator_Statistics* SIM800Simulator_statistics (void)
+{
+    return &statistics;
+}
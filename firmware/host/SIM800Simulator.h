@@ -0,0 +1,74 @@
+//
+//  SIM800 simulator
+//
+//  What it does:
+//    Plays the part of the SIM800 on the host: takes the AT commands that
+//    SIM800.c sends on SoftwareSerialTx channel 0 and answers them from a
+//    script, pushing the replies into the SoftwareSerialRx0 queue at the
+//    rate of the serial link, after the latency the script gives. The
+//    power key is watched the way the module does, so power up and power
+//    down go through SIM800.c as they do on the board.
+//
+//    A script is a list of exchanges. When a command line arrives, the
+//    first exchange whose command is a prefix of the line, and that
+//    applies to this occurrence of it, gives the reply. Scripting one
+//    occurrence of a command differently from the others is how faults
+//    (an ERROR, a CONNECT FAIL, a lost reply) are put into a dialog.
+//    Commands no exchange applies to are answered with ERROR and counted.
+//
+//  How to use it:
+//    Call SIM800Simulator_Initialize with the script after
+//    SystemTime_Initialize and SoftwareSerialTx_Initialize, and before
+//    SIM800_Initialize (or CellularComm_Initialize). Then let time pass
+//    with HostHAL_runTicks while running the firmware tasks.
+//
+#ifndef SIM800SIMULATOR_H
+#define SIM800SIMULATOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef struct SIM800Simulator_Exchange_struct {
+    const char* command;    // prefix of the command line, or NULL for the
+                            // exchange that runs when the module powers up
+    uint8_t first;          // first occurrence of the command it applies to,
+                            // counting from 0
+    uint8_t count;          // number of occurrences it applies to, or 0 for
+                            // all of them from first on
+    uint16_t latency;       // 1/100 s from the end of the command to reply
+    const char* reply;      // NULL sends nothing, as if the reply was lost.
+                            // a reply that ends with the "> " prompt takes
+                            // data: as many bytes as the command's "=n", or
+                            // up to a Ctrl-Z
+    uint16_t laterLatency;  // 1/100 s from the reply, or from the end of
+                            // the data, to the later reply
+    const char* laterReply; // NULL if none. "%u" is replaced by the number
+                            // of data bytes taken
+} SIM800Simulator_Exchange;
+
+typedef struct SIM800Simulator_Statistics_struct {
+    uint16_t commands;
+    uint16_t unscriptedCommands;
+    uint32_t dataBytes;     // taken after prompts
+    uint32_t replyBytes;
+    uint16_t rxOverruns;    // reply bytes lost to a full rx queue
+} SIM800Simulator_Statistics;
+
+extern void SIM800Simulator_Initialize (
+    const SIM800Simulator_Exchange* script,
+    const uint8_t scriptLength);
+
+// scales every latency in the script, e.g. 200 for twice as slow
+extern void SIM800Simulator_setLatencyPercent (
+    const uint16_t percent);
+
+// when on, the commands and replies are printed with the time they
+// happened
+extern void SIM800Simulator_setTrace (
+    const bool trace);
+
+extern bool SIM800Simulator_isPoweredOn (void);
+
+extern const SIM800Simulator_Statistics* SIM800Simulator_statistics (void);
+
+#endif  // SIM800SIMULATOR_H
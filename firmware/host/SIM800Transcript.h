@@ -0,0 +1,53 @@
+//
+//  SIM800 transcript
+//
+//  What the SIM800 sent during one reporting cycle of a unit in the field:
+//  power-up, registration, bringing up GPRS, connecting to the host, one
+//  sample sent in quick send mode, a command from the host and its reply,
+//  and closing down. Used as input by the host benchmarks.
+//
+#ifndef SIM800TRANSCRIPT_H
+#define SIM800TRANSCRIPT_H
+
+static const char SIM800Transcript[] =
+    "\r\nRDY\r\n"
+    "\r\n+CFUN: 1\r\n"
+    "\r\n+CPIN: READY\r\n"
+    "\r\nCall Ready\r\n"
+    "\r\nSMS Ready\r\n"
+    "\r\nOK\r\n"
+    "\r\n+CSQ: 9,0\r\n\r\nOK\r\n"
+    "\r\n+CREG: 0,2\r\n\r\nOK\r\n"
+    "\r\n+CSQ: 14,0\r\n\r\nOK\r\n"
+    "\r\n+CREG: 0,1\r\n\r\nOK\r\n"
+    "\r\n+CBC: 0,86,4071\r\n\r\nOK\r\n"
+    "\r\n+CCLK: \"26/10/16,08:30:02-16\"\r\n\r\nOK\r\n"
+    "\r\n+CGATT: 1\r\n\r\nOK\r\n"
+    "\r\nOK\r\n"
+    "\r\nSTATE: IP INITIAL\r\n"
+    "\r\nOK\r\n"
+    "\r\nOK\r\n"
+    "\r\nOK\r\n"
+    "\r\nSTATE: IP START\r\n"
+    "\r\nOK\r\n"
+    "\r\nSTATE: IP GPRSACT\r\n"
+    "\r\n10.163.42.77\r\n"
+    "\r\nSTATE: IP STATUS\r\n"
+    "\r\nOK\r\n"
+    "\r\nCONNECT OK\r\n"
+    "\r\n+CSQ: 15,0\r\n\r\nOK\r\n"
+    "\r\nSTATE: CONNECT OK\r\n"
+    "\r\n> "
+    "\r\nDATA ACCEPT:42\r\n"
+    "\r\n+IPD,16:get logInterval\n"
+    "\r\nSTATE: CONNECT OK\r\n"
+    "\r\n> "
+    "\r\nDATA ACCEPT:24\r\n"
+    "\r\n+CIPACK: 66,66,0\r\n\r\nOK\r\n"
+    "\r\n+IPD,12:session off\n"
+    "\r\n+CSQ: 15,0\r\n\r\nOK\r\n"
+    "\r\nCLOSE OK\r\n"
+    "\r\nSHUT OK\r\n"
+    "\r\nNORMAL POWER DOWN\r\n";
+
+#endif  // SIM800TRANSCRIPT_H
@@ -0,0 +1,283 @@
+//
+//  SPSCByteQueue stress test
+//
+//  What it does:
+//    Runs a producer and a consumer on two threads against one small
+//    queue, so that the 8-bit indices wrap thousands of times, and checks
+//    that every byte arrives once and in order, that the drop count
+//    matches the pushes that failed, and that the high watermark is
+//    right, including across an index wrap.
+//    Both sides mix the single-byte, block and span operations.
+//    The threads run on the small queue and on a 256 byte one, and the
+//    256 byte one is also checked to hold 255 bytes.
+//    The queue relies on bytes being stored before the index that
+//    publishes them, which holds on the AVR and on x86 hosts.
+//
+//  How to use it:
+//    "make test", or run ./SPSCByteQueueStressTest [bytes]
+//
+#include <stdlib.h>
+#include <pthread.h>
+#include <sched.h>
+#include "SPSCByteQueue.h"
+#include "HostTest.h"
+
+#define QUEUE_CAPACITY 16
+
+SPSCByteQueue_define(QUEUE_CAPACITY, queue, static);
+// the largest buffer, which holds one byte less than its size
+SPSCByteQueue_define(256, bigQueue, static);
+
+// the queue the threads are using
+static SPSCByteQueue_t *testQueue;
+
+static uint32_t numBytes = 1000000;
+static bool lossy;                  // producer gives up on full queue
+static volatile bool producerDone;
+
+// sequence numbers the producer got into the queue, in order, and the
+// bytes the consumer got out of it
+static uint32_t *accepted;
+static uint32_t numAccepted;
+static uint32_t producerDrops;      // bytes that didn't fit, retried or not
+static ByteQueueElement *received;
+static uint32_t numReceived;
+
+static void* producer (
+    void* arg)
+{
+    uint32_t seq = 0;
+    uint32_t op = 0;
+    while (seq < numBytes) {
+        if ((op++ % 3) == 0) {
+            if (SPSCByteQueue_push((ByteQueueElement)seq, testQueue)) {
+                accepted[numAccepted++] = seq;
+                ++seq;
+            } else {
+                ++producerDrops;
+                if (lossy) {
+                    ++seq;
+                } else {
+                    // retry once the consumer has run, even on a single
+                    // processor
+                    sched_yield();
+                }
+            }
+        } else {
+            ByteQueueElement block[7];
+            uint8_t count = 1 + (op % 7);
+            if (count > (numBytes - seq)) {
+                count = numBytes - seq;
+            }
+            for (uint8_t i = 0; i < count; ++i) {
+                block[i] = (ByteQueueElement)(seq + i);
+            }
+            const uint8_t pushed = SPSCByteQueue_pushBlock(block, count, testQueue);
+            for (uint8_t i = 0; i < pushed; ++i) {
+                accepted[numAccepted++] = seq + i;
+            }
+            producerDrops += count - pushed;
+            if (lossy) {
+                seq += count;
+            } else {
+                seq += pushed;
+                if (pushed < count) {
+                    sched_yield();
+                }
+            }
+        }
+        if ((op % 64) == 0) {
+            sched_yield();
+        }
+    }
+    producerDone = true;
+    return NULL;
+}
+
+static void* consumer (
+    void* arg)
+{
+    uint32_t op = 0;
+    for (;;) {
+        // read the flag before looking at the queue, so that a queue
+        // found empty after the producer is done is empty for good
+        const bool done = producerDone;
+        SPSCBYTEQUEUE_BARRIER();
+        if (SPSCByteQueue_is_empty(testQueue)) {
+            if (done) {
+                break;
+            }
+            sched_yield();
+            continue;
+        }
+        switch (op++ % 3) {
+            case 0 :
+                received[numReceived++] = SPSCByteQueue_pop(testQueue);
+                break;
+            case 1 :
+                numReceived += SPSCByteQueue_popBlock(
+                    &received[numReceived], 1 + (op % 5), testQueue);
+                break;
+            default : {
+                const ByteQueueElement *span;
+                const uint8_t length = SPSCByteQueue_peekSpan(testQueue, &span);
+                for (uint8_t i = 0; i < length; ++i) {
+                    received[numReceived++] = span[i];
+                }
+                SPSCByteQueue_commitSpan(length, testQueue);
+                }
+                break;
+        }
+        if (lossy && ((op % 16) == 0)) {
+            // fall behind now and then so that the queue fills up
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void runThreads (
+    SPSCByteQueue_t *q,
+    const bool lossyProducer)
+{
+    testQueue = q;
+    SPSCByteQueue_clear(testQueue);
+    testQueue->highwater = 0;
+    testQueue->drops = 0;
+    lossy = lossyProducer;
+    producerDone = false;
+    numAccepted = 0;
+    producerDrops = 0;
+    numReceived = 0;
+
+    pthread_t producerThread;
+    pthread_t consumerThread;
+    pthread_create(&consumerThread, NULL, consumer, NULL);
+    pthread_create(&producerThread, NULL, producer, NULL);
+    pthread_join(producerThread, NULL);
+    pthread_join(consumerThread, NULL);
+
+    // every accepted byte arrived once, in order
+    HostTest_check(numReceived == numAccepted);
+    uint32_t mismatches = 0;
+    for (uint32_t i = 0; (i < numReceived) && (i < numAccepted); ++i) {
+        if (received[i] != (ByteQueueElement)accepted[i]) {
+            ++mismatches;
+        }
+    }
+    HostTest_check(mismatches == 0);
+
+    // the queue counted exactly the bytes that didn't fit (modulo the
+    // 16-bit counter)
+    HostTest_check(SPSCByteQueue_drops(testQueue) == (uint16_t)producerDrops);
+    if (lossy) {
+        HostTest_check((numAccepted + producerDrops) == numBytes);
+    } else {
+        HostTest_check(numAccepted == numBytes);
+    }
+    // pushes only fail on a full queue
+    const uint8_t capacity = SPSCByteQueue_capacity(testQueue);
+    HostTest_check(testQueue->highwater <= capacity);
+    HostTest_check((producerDrops == 0) || (testQueue->highwater == capacity));
+    if (lossy) {
+        HostTest_check(producerDrops > 0);
+    }
+}
+
+static void testHighwaterAcrossWrap (void)
+{
+    // move the indices to just before the 8-bit wrap, then fill across it
+    SPSCByteQueue_clear(&queue);
+    queue.head = 250;
+    queue.tail = 250;
+    queue.highwater = 0;
+    queue.drops = 0;
+    for (uint8_t i = 0; i < 10; ++i) {
+        HostTest_check(SPSCByteQueue_push(i, &queue));
+    }
+    HostTest_check(queue.tail == 4);
+    HostTest_check(SPSCByteQueue_length(&queue) == 10);
+    HostTest_check(queue.highwater == 10);
+
+    // draining and refilling to a lower level leaves the watermark alone
+    ByteQueueElement bytes[QUEUE_CAPACITY];
+    HostTest_check(SPSCByteQueue_popBlock(bytes, 8, &queue) == 8);
+    HostTest_check((bytes[0] == 0) && (bytes[7] == 7));
+    const ByteQueueElement block[5] = {10, 11, 12, 13, 14};
+    HostTest_check(SPSCByteQueue_pushBlock(block, 5, &queue) == 5);
+    HostTest_check(queue.highwater == 10);
+
+    // filling past capacity with a block sets the watermark to capacity
+    // and counts the rest as dropped
+    ByteQueueElement fill[QUEUE_CAPACITY];
+    memset(fill, 0x55, sizeof(fill));
+    HostTest_check(SPSCByteQueue_pushBlock(fill, QUEUE_CAPACITY, &queue) == (QUEUE_CAPACITY - 7));
+    HostTest_check(queue.highwater == QUEUE_CAPACITY);
+    HostTest_check(SPSCByteQueue_drops(&queue) == 7);
+    HostTest_check(!SPSCByteQueue_push(0, &queue));
+    HostTest_check(SPSCByteQueue_drops(&queue) == 8);
+
+    // contents survive the wrap
+    HostTest_check(SPSCByteQueue_popBlock(bytes, 7, &queue) == 7);
+    HostTest_check((bytes[0] == 8) && (bytes[1] == 9) && (bytes[2] == 10) && (bytes[6] == 14));
+}
+
+static void testFullSizeBuffer (void)
+{
+    // a 256 byte buffer is full at 255 bytes
+    SPSCByteQueue_clear(&bigQueue);
+    bigQueue.highwater = 0;
+    bigQueue.drops = 0;
+    HostTest_check(SPSCByteQueue_capacity(&bigQueue) == 255);
+    ByteQueueElement fill[255];
+    for (uint16_t i = 0; i < sizeof(fill); ++i) {
+        fill[i] = (ByteQueueElement)i;
+    }
+    HostTest_check(SPSCByteQueue_pushBlock(fill, 255, &bigQueue) == 255);
+    HostTest_check(SPSCByteQueue_is_full(&bigQueue));
+    HostTest_check(SPSCByteQueue_spaceRemaining(&bigQueue) == 0);
+    HostTest_check(!SPSCByteQueue_push(0, &bigQueue));
+    HostTest_check(SPSCByteQueue_drops(&bigQueue) == 1);
+    HostTest_check(bigQueue.highwater == 255);
+
+    // the whole queue is one span, since it starts at the beginning of
+    // the buffer
+    const ByteQueueElement *span;
+    HostTest_check(SPSCByteQueue_peekSpan(&bigQueue, &span) == 255);
+    HostTest_check((span[0] == 0) && (span[254] == 254));
+    SPSCByteQueue_commitSpan(255, &bigQueue);
+    HostTest_check(SPSCByteQueue_is_empty(&bigQueue));
+
+    // fill again across the end of the buffer, and read it back
+    HostTest_check(SPSCByteQueue_push(0xAA, &bigQueue));
+    HostTest_check(SPSCByteQueue_pushBlock(fill, 255, &bigQueue) == 254);
+    HostTest_check(SPSCByteQueue_drops(&bigQueue) == 2);
+    HostTest_check(SPSCByteQueue_peekSpan(&bigQueue, &span) == 1);
+    HostTest_check(SPSCByteQueue_pop(&bigQueue) == 0xAA);
+    ByteQueueElement bytes[255];
+    HostTest_check(SPSCByteQueue_popBlock(bytes, 255, &bigQueue) == 254);
+    HostTest_check((bytes[0] == 0) && (bytes[253] == 253));
+    HostTest_check(SPSCByteQueue_is_empty(&bigQueue));
+}
+
+int main (
+    int argc,
+    char** argv)
+{
+    if (argc > 1) {
+        numBytes = strtoul(argv[1], NULL, 10);
+    }
+    accepted = malloc(numBytes * sizeof(accepted[0]));
+    received = malloc(numBytes * sizeof(received[0]));
+
+    testHighwaterAcrossWrap();
+    testFullSizeBuffer();
+    runThreads(&queue, false);
+    runThreads(&queue, true);
+    runThreads(&bigQueue, false);
+    runThreads(&bigQueue, true);
+
+    free(accepted);
+    free(received);
+    return HostTest_finish("SPSCByteQueueStressTest");
+}
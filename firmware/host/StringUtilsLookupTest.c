@@ -0,0 +1,113 @@
+//
+//  StringUtils incremental lookup test
+//
+//  What it does:
+//    Checks that StringUtils_beginLookup/lookupChar/lookupResult classify
+//    a string the same way StringUtils_lookupString does, over the three
+//    tables the SIM800 parser uses. Every entry is checked, along with
+//    every prefix of it, the entry with a character appended, and the
+//    entry with its last character changed, so both the matches and the
+//    near misses are covered.
+//
+//  How to use it:
+//    "make test", or run ./StringUtilsLookupTest
+//
+#include <string.h>
+#include "CharString.h"
+#include "CharStringSpan.h"
+#include "StringUtils.h"
+#include "SIM800.h"
+#include "HostTest.h"
+
+// the tables are defined in SIM800.c
+extern PGM_P SIM800_ResponseMessageTable[];
+extern PGM_P plusMessageTable[];
+extern PGM_P ipStateTable[];
+
+// in sync with the PlusMessage enum in SIM800.c
+#define PLUS_MESSAGE_TABLE_SIZE 13
+
+static int incrementalLookup (
+    const char* str,
+    const uint8_t length,
+    PGM_P table[],
+    const int tableSize)
+{
+    StringUtils_Lookup_t lookup;
+    StringUtils_beginLookup(tableSize, &lookup);
+    for (uint8_t i = 0; i < length; ++i) {
+        StringUtils_lookupChar(str[i], table, &lookup);
+    }
+    return StringUtils_lookupResult(table, tableSize, &lookup);
+}
+
+static int wholeLookup (
+    const char* str,
+    const uint8_t length,
+    PGM_P table[],
+    const int tableSize)
+{
+    CharString_define(40, cs);
+    CharString_clear(&cs);
+    for (uint8_t i = 0; i < length; ++i) {
+        CharString_appendC(str[i], &cs);
+    }
+    CharStringSpan_t span;
+    CharStringSpan_init(&cs, &span);
+    return StringUtils_lookupString(&span, table, tableSize);
+}
+
+static void checkString (
+    const char* str,
+    const uint8_t length,
+    PGM_P table[],
+    const int tableSize)
+{
+    const int expected = wholeLookup(str, length, table, tableSize);
+    const int result = incrementalLookup(str, length, table, tableSize);
+    if (!HostTest_check(result == expected)) {
+        printf("  \"%.*s\": %d, expected %d\n", length, str, result, expected);
+    }
+}
+
+static void checkTable (
+    PGM_P table[],
+    const int tableSize)
+{
+    for (int index = 0; index < tableSize; ++index) {
+        char entry[40];
+        strcpy_P(entry, (PGM_P)pgm_read_word(&table[index]));
+        const uint8_t length = strlen(entry);
+
+        // the entry itself must be found where it is
+        HostTest_check(incrementalLookup(entry, length, table, tableSize) == index);
+
+        // every prefix, including the empty string and the entry itself
+        for (uint8_t prefix = 0; prefix <= length; ++prefix) {
+            checkString(entry, prefix, table, tableSize);
+        }
+
+        // longer than the entry
+        entry[length] = 'X';
+        checkString(entry, length + 1, table, tableSize);
+        entry[length] = ' ';
+        checkString(entry, length + 1, table, tableSize);
+
+        // same length, last character just before and just after
+        const char last = entry[length - 1];
+        entry[length - 1] = last - 1;
+        checkString(entry, length, table, tableSize);
+        entry[length - 1] = last + 1;
+        checkString(entry, length, table, tableSize);
+        entry[length - 1] = last;
+    }
+}
+
+int main (void)
+{
+    checkTable(SIM800_ResponseMessageTable, rm_unrecognized);
+    checkTable(plusMessageTable, PLUS_MESSAGE_TABLE_SIZE);
+    checkTable(ipStateTable, ips_unknown);
+
+    return HostTest_finish("StringUtilsLookupTest");
+}
@@ -0,0 +1,462 @@
+//
+//  TFT drawing benchmark
+//
+//  What it does:
+//    Runs the TFT driver, TFT_HXD8357D.c, against the SPI model in
+//    HostHAL.c and compares it with the drawing the driver did before the
+//    SPI repeat engine and text runs: spiWrite16 sending one byte at a
+//    time through SPIAsync_sendByte, 300 pixels per task run for
+//    rectangles and one spiWrite16 call per pixel for glyphs.
+//    For a fill of the display body (the 480x290 area below the header)
+//    it reports the task runs, the SPI bytes per run and the host time per
+//    run; on the device the longest run is what "prof" reports as the TFT
+//    task's maximum. For the clock and percent labels it reports the SPI
+//    bytes and host time per glyph. Both paths must send the same bytes,
+//    and the benchmark fails if they don't.
+//    Since the bytes are the same, on the device the repeat engine and
+//    the runs can only save the loop overhead on top of the wire time,
+//    which is 32 cycles a byte at FOSC/4. The host times include the SPI
+//    model's cost per byte in place of the wire time, so they show the
+//    relative loop overhead, not AVR timings.
+//
+//  How to use it:
+//    "make bench", or run ./TFTBenchmark [repetitions]
+//
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <avr/io.h>
+#include "HostHAL.h"
+#include "SystemTime.h"
+#include "SPIAsync.h"
+#include "TFT_HXD8357D.h"
+#include "DisplayFonts.h"
+#include "CharString.h"
+#include "CharStringSpan.h"
+
+// as in TFT_HXD8357D.c
+#define MAX_PIXELS_PER_BURST 300
+#define HX8357_CASET 0x2A
+#define HX8357_PASET 0x2B
+#define HX8357_RAMWR 0x2C
+#define DC_PIN PB7
+#define SS_PIN PD6
+
+// device SPI clock is F_CPU / 4, so a byte takes 32 cycles on the wire
+#define SPI_BYTE_NS (32 * (1000000000UL / F_CPU))
+
+static uint32_t repetitions = 200;
+
+typedef void (*TaskFunction)(void);
+
+//
+// what was sent, as a hash of the bytes and their data/command flag
+//
+static uint32_t spiBytes;
+static uint32_t spiHash;
+
+static void spiSink (
+    const uint8_t byte)
+{
+    const uint32_t dc = (PORTB >> DC_PIN) & 1;
+    ++spiBytes;
+    spiHash = (spiHash ^ byte ^ (dc << 8)) * 16777619UL;
+}
+
+static void resetSPIRecord (void)
+{
+    spiBytes = 0;
+    spiHash = 2166136261UL;
+}
+
+static uint64_t nowNs (void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (((uint64_t)ts.tv_sec) * 1000000000ULL) + ts.tv_nsec;
+}
+
+//
+// what there is to draw
+//
+static TFT_HXD8357D_Rectangle rectangle;
+static bool rectanglePending = false;
+static TFT_HXD8357D_Text text;
+static bool textPending = false;
+
+static const TFT_HXD8357D_Rectangle* rectangleSource (void)
+{
+    if (!rectanglePending) {
+        return NULL;
+    }
+    rectanglePending = false;
+    return &rectangle;
+}
+
+static const TFT_HXD8357D_Text* textSource (void)
+{
+    if (!textPending) {
+        return NULL;
+    }
+    textPending = false;
+    return &text;
+}
+
+//
+// the rectangle fill and text drawing as they were before the SPI repeat
+// engine and text runs
+//
+typedef enum OldState_enum {
+    olds_idle,
+    olds_drawingRectangle,
+    olds_drawingText
+} OldState;
+static OldState oldState = olds_idle;
+static uint16_t oldRectColor;
+static uint32_t oldRectRemainingPixels;
+static uint16_t oldCharX;
+static uint16_t oldCharY;
+static CharString_Iter oldTextIter;
+static CharString_Iter oldTextEndIter;
+static uint16_t oldTextFGColor;
+static uint16_t oldTextBGColor;
+
+static void oldSpiWrite16 (
+    const uint16_t word,
+    const uint16_t repeat)
+{
+    const uint8_t hi = word >> 8;
+    const uint8_t lo = word & 0xFF;
+    uint16_t remaining = repeat;
+    while (remaining-- > 0) {
+        while (!SPIAsync_operationCompleted());
+        SPIAsync_sendByte(hi);
+        while (!SPIAsync_operationCompleted());
+        SPIAsync_sendByte(lo);
+    }
+    while (!SPIAsync_operationCompleted());
+}
+
+static void oldWriteCommand (
+    const uint8_t cmd)
+{
+    PORTB &= ~(1 << DC_PIN);
+    SPIAsync_sendByte(cmd);
+    while (!SPIAsync_operationCompleted());
+    PORTB |= (1 << DC_PIN);
+}
+
+static void oldSetWindow (
+    const uint16_t x,
+    const uint16_t y,
+    const uint16_t width,
+    const uint16_t height)
+{
+    oldWriteCommand(HX8357_CASET);
+    oldSpiWrite16(x, 1);
+    oldSpiWrite16(x + width - 1, 1);
+    oldWriteCommand(HX8357_PASET);
+    oldSpiWrite16(y, 1);
+    oldSpiWrite16(y + height - 1, 1);
+    oldWriteCommand(HX8357_RAMWR);
+}
+
+static bool oldContinueText (void)
+{
+    const GFXfont *font = DisplayFonts_primary();
+    const uint8_t c = (*oldTextIter) - (uint8_t)pgm_read_byte(&font->first);
+    GFXglyph *glyph  = &(((GFXglyph *)pgm_read_word(&font->glyph))[c]);
+    uint8_t  *bitmap = (uint8_t *)pgm_read_word(&font->bitmap);
+    int8_t yTop = pgm_read_byte(&font->yTop);
+    int8_t yBottom = pgm_read_byte(&font->yBottom);
+
+    uint8_t h = DisplayFonts_fontHeight(font);
+    uint16_t bo = pgm_read_word(&glyph->bitmapOffset);
+    uint8_t  gw  = pgm_read_byte(&glyph->width);
+    uint8_t  gh  = pgm_read_byte(&glyph->height);
+    uint8_t  w  = pgm_read_byte(&glyph->xAdvance);
+    int8_t   gxo = pgm_read_byte(&glyph->xOffset);
+    int8_t   gyo = pgm_read_byte(&glyph->yOffset);
+    uint8_t  bits = 0;
+    uint8_t  bit = 0;
+
+    oldSetWindow(oldCharX, oldCharY, w, h);
+
+    const uint16_t spaceAbove = gyo - yTop;
+    if (spaceAbove > 0) {
+        oldSpiWrite16(oldTextBGColor, spaceAbove * w);
+    }
+    for (int yy = 0; yy < gh; yy++) {
+        if (gxo > 0) {
+            oldSpiWrite16(oldTextBGColor, gxo);
+        }
+        for (int xx = 0; xx < gw; xx++) {
+            if (!(bit++ & 7)) {
+                bits = pgm_read_byte(&bitmap[bo++]);
+            }
+            oldSpiWrite16(((bits & 0x80) != 0)
+                          ? oldTextFGColor
+                          : oldTextBGColor, 1);
+            bits <<= 1;
+        }
+        const uint8_t spaceRight = w - (gxo + gw);
+        if (spaceRight > 0) {
+            oldSpiWrite16(oldTextBGColor, spaceRight);
+        }
+    }
+    const uint16_t spaceBelow = yBottom - (gyo + gh);
+    if (spaceBelow > 0) {
+        oldSpiWrite16(oldTextBGColor, spaceBelow * w);
+    }
+
+    oldCharX += w;
+    ++oldTextIter;
+    if (oldTextIter == oldTextEndIter) {
+        SPIAsync_deassertSS();
+        return false;
+    } else {
+        return true;
+    }
+}
+
+static void oldTask (void)
+{
+    switch (oldState) {
+        case olds_idle: {
+            const TFT_HXD8357D_Rectangle *r = rectangleSource();
+            const TFT_HXD8357D_Text *t = (r == NULL) ? textSource() : NULL;
+            if (r != NULL) {
+                SPIAsync_assertSS();
+                oldSetWindow(r->x, r->y, r->width, r->height);
+                oldRectColor = r->color;
+                oldRectRemainingPixels = ((uint32_t)r->width) * r->height;
+                oldState = olds_drawingRectangle;
+            } else if (t != NULL) {
+                SPIAsync_assertSS();
+                oldCharX = t->x;
+                oldCharY = t->y;
+                oldTextIter = CharStringSpan_begin(&t->chars);
+                oldTextEndIter = CharStringSpan_end(&t->chars);
+                oldTextFGColor = t->fgColor;
+                oldTextBGColor = t->bgColor;
+                oldState = olds_drawingText;
+            }
+            }
+            break;
+        case olds_drawingRectangle: {
+            const uint16_t pixelsToWrite =
+                (oldRectRemainingPixels > MAX_PIXELS_PER_BURST)
+                ? MAX_PIXELS_PER_BURST
+                : oldRectRemainingPixels;
+            oldSpiWrite16(oldRectColor, pixelsToWrite);
+            oldRectRemainingPixels -= pixelsToWrite;
+            if (oldRectRemainingPixels == 0) {
+                SPIAsync_deassertSS();
+                oldState = olds_idle;
+            }
+            }
+            break;
+        case olds_drawingText:
+            if (!oldContinueText()) {
+                oldState = olds_idle;
+            }
+            break;
+    }
+}
+
+//
+// measurement
+//
+typedef struct FillResult_struct {
+    uint32_t runs;
+    uint32_t bytes;
+    uint32_t maxRunBytes;
+    uint32_t hash;
+    uint64_t totalNs;
+    uint64_t maxRunNs;
+} FillResult;
+
+// runs task until the SS pin is released, timing each run. The first run
+// is the one that takes the rectangle from the source
+static void runUntilDone (
+    const TaskFunction task,
+    FillResult *result)
+{
+    result->runs = 0;
+    result->maxRunBytes = 0;
+    result->totalNs = 0;
+    result->maxRunNs = 0;
+    do {
+        const uint32_t bytesBefore = spiBytes;
+        const uint64_t start = nowNs();
+        task();
+        const uint64_t elapsed = nowNs() - start;
+        ++result->runs;
+        result->totalNs += elapsed;
+        if (elapsed > result->maxRunNs) {
+            result->maxRunNs = elapsed;
+        }
+        if ((spiBytes - bytesBefore) > result->maxRunBytes) {
+            result->maxRunBytes = spiBytes - bytesBefore;
+        }
+    } while ((PORTD & (1 << SS_PIN)) == 0);
+}
+
+// fills the rectangle repetitions times. The times are the smallest seen
+// over the repetitions, to keep host scheduling out of them
+static void measureFill (
+    const TaskFunction task,
+    FillResult *result)
+{
+    uint64_t bestTotalNs = UINT64_MAX;
+    uint64_t bestMaxRunNs = UINT64_MAX;
+    for (uint32_t i = 0; i < repetitions; ++i) {
+        resetSPIRecord();
+        rectanglePending = true;
+        runUntilDone(task, result);
+        if (result->totalNs < bestTotalNs) {
+            bestTotalNs = result->totalNs;
+        }
+        if (result->maxRunNs < bestMaxRunNs) {
+            bestMaxRunNs = result->maxRunNs;
+        }
+    }
+    result->bytes = spiBytes;
+    result->hash = spiHash;
+    result->totalNs = bestTotalNs;
+    result->maxRunNs = bestMaxRunNs;
+}
+
+static void reportFill (
+    const char* name,
+    const FillResult *result)
+{
+    printf("%-32s %6lu runs %8lu bytes  max %5lu bytes/run"
+           "  %8.1f ns/run  max %8.1f ns/run\n",
+           name,
+           (unsigned long)result->runs,
+           (unsigned long)result->bytes,
+           (unsigned long)result->maxRunBytes,
+           ((double)result->totalNs) / result->runs,
+           (double)result->maxRunNs);
+}
+
+// draws the label repetitions times and returns the smallest time taken
+static uint64_t measureLabel (
+    const TaskFunction task,
+    FillResult *result)
+{
+    uint64_t bestTotalNs = UINT64_MAX;
+    for (uint32_t i = 0; i < repetitions; ++i) {
+        resetSPIRecord();
+        textPending = true;
+        runUntilDone(task, result);
+        if (result->totalNs < bestTotalNs) {
+            bestTotalNs = result->totalNs;
+        }
+    }
+    result->bytes = spiBytes;
+    result->hash = spiHash;
+    return bestTotalNs;
+}
+
+static bool benchLabel (
+    const char* name,
+    const char* label,
+    const uint16_t x,
+    const uint16_t y,
+    const uint16_t fgColor,
+    const uint16_t bgColor)
+{
+    CharString_define(20, labelString);
+    CharString_copy(label, &labelString);
+    CharStringSpan_init(&labelString, &text.chars);
+    text.x = x;
+    text.y = y;
+    text.fgColor = fgColor;
+    text.bgColor = bgColor;
+    const uint32_t glyphs = CharString_length(&labelString);
+
+    FillResult oldResult;
+    FillResult newResult;
+    const uint64_t oldNs = measureLabel(oldTask, &oldResult);
+    const uint64_t newNs = measureLabel(TFT_HXD8357D_task, &newResult);
+
+    printf("%s \"%s\", %lu glyphs, %lu bytes/glyph\n",
+        name, label, (unsigned long)glyphs,
+        (unsigned long)(newResult.bytes / glyphs));
+    printf("  %-30s %8.1f ns/glyph\n", "pixel at a time (before)",
+        ((double)oldNs) / glyphs);
+    printf("  %-30s %8.1f ns/glyph\n", "color runs", ((double)newNs) / glyphs);
+    printf("  %-30s %8.2fx\n", "before/after", ((double)oldNs) / newNs);
+
+    if ((oldResult.bytes != newResult.bytes) ||
+        (oldResult.hash != newResult.hash)) {
+        printf("FAIL: the two paths sent different bytes\n");
+        return false;
+    }
+    return true;
+}
+
+static bool benchBodyFill (void)
+{
+    rectangle.x = 0;
+    rectangle.y = 30;
+    rectangle.width = TFT_HXD8357D_width;
+    rectangle.height = TFT_HXD8357D_height - 30;
+    rectangle.color = HX8357_WHITE;
+
+    FillResult oldResult;
+    FillResult newResult;
+    measureFill(oldTask, &oldResult);
+    measureFill(TFT_HXD8357D_task, &newResult);
+
+    printf("body fill %ux%u\n", rectangle.width, rectangle.height);
+    reportFill("  byte loop (before)", &oldResult);
+    reportFill("  repeat engine", &newResult);
+    printf("  wire time of the longest run   %8.1f us on the device\n",
+        (((double)newResult.maxRunBytes) * SPI_BYTE_NS) / 1000);
+    printf("  loop time, before/after        %8.2fx per run\n",
+        ((double)oldResult.totalNs / oldResult.runs) /
+        ((double)newResult.totalNs / newResult.runs));
+
+    if ((oldResult.bytes != newResult.bytes) ||
+        (oldResult.hash != newResult.hash)) {
+        printf("FAIL: the two paths sent different bytes\n");
+        return false;
+    }
+    return true;
+}
+
+int main (
+    int argc,
+    char** argv)
+{
+    if (argc > 1) {
+        repetitions = strtoul(argv[1], NULL, 10);
+    }
+
+    HostHAL_setConsoleQuiet(true);
+    SystemTime_Initialize();
+    TFT_HXD8357D_Initialize();
+    TFT_HXD8357D_setRectangleSource(rectangleSource);
+    TFT_HXD8357D_setTextSource(textSource);
+
+    // bring the display up to idle, which takes under a second
+    for (int i = 0; i < 100; ++i) {
+        TFT_HXD8357D_task();
+        HostHAL_runTicks(SYSTEMTIME_TICKS_PER_SECOND / 100);
+    }
+    HostHAL_setSPISink(spiSink);
+
+    bool ok = benchBodyFill();
+    // the status bar clock and battery percent, and the water level
+    ok = benchLabel("clock", "Tue 12:34:56  ", TFT_HXD8357D_width - 160, 5,
+                    HX8357_BLACK, HX8357_GREEN) && ok;
+    ok = benchLabel("battery", "B:85%  ", 75, 5,
+                    HX8357_BLACK, HX8357_GREEN) && ok;
+    ok = benchLabel("level", "85%", 220, 150,
+                    HX8357_WHITE, HX8357_BLUE) && ok;
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,101 @@
+//
+//  Task scheduler test
+//
+//  What it does:
+//    Runs a table of three tasks for ten seconds of ticks, one pass
+//    through the scheduler per tick, and checks that a task with period 0
+//    runs on every pass, that a periodic task runs once per period, and
+//    that a task which calls TaskScheduler_setCurrentTaskDelay while it is
+//    busy comes back after that delay and returns to its own period once
+//    it stops calling it, without changing when the other tasks run.
+//
+//  How to use it:
+//    "make test", or run ./TaskSchedulerTest
+//
+#include "HostHAL.h"
+#include "SystemTime.h"
+#include "TaskScheduler.h"
+#include "HostTest.h"
+
+#define NUM_PASSES (10 * SYSTEMTIME_TICKS_PER_SECOND)
+#define SHORT_PERIOD 48
+#define BUSY_DELAY 24
+#define BUSY_RUNS 3
+#define MAX_RECORDED_RUNS 8
+
+static uint16_t startTicks;
+static uint32_t everyPassRuns;
+static uint32_t periodicRuns;
+static uint16_t lastPeriodicTicks;
+static bool periodicIntervalsRight = true;
+static uint8_t busyRunsLeft = BUSY_RUNS;
+static uint16_t busyRunTicks[MAX_RECORDED_RUNS];
+static uint8_t busyRuns;
+
+static void everyPassTask (void)
+{
+    ++everyPassRuns;
+}
+
+static void sometimesBusyTask (void)
+{
+    if (busyRuns < MAX_RECORDED_RUNS) {
+        busyRunTicks[busyRuns] = SystemTime_ticks() - startTicks;
+    }
+    ++busyRuns;
+    if (busyRunsLeft > 0) {
+        --busyRunsLeft;
+        TaskScheduler_setCurrentTaskDelay(BUSY_DELAY);
+    }
+}
+
+static void periodicTask (void)
+{
+    const uint16_t now = SystemTime_ticks();
+    if ((periodicRuns != 0) &&
+        ((uint16_t)(now - lastPeriodicTicks) != SHORT_PERIOD)) {
+        periodicIntervalsRight = false;
+    }
+    lastPeriodicTicks = now;
+    ++periodicRuns;
+}
+
+static char everyPassTaskP[]    PROGMEM = "everyPass";
+static char sometimesBusyTaskP[] PROGMEM = "sometimesBusy";
+static char periodicTaskP[]     PROGMEM = "periodic";
+
+static const TaskScheduler_TaskDesc tasks[] PROGMEM = {
+    {everyPassTask,     0,                              everyPassTaskP},
+    {sometimesBusyTask, SYSTEMTIME_TICKS_PER_SECOND,    sometimesBusyTaskP},
+    {periodicTask,      SHORT_PERIOD,                   periodicTaskP}
+};
+
+int main (void)
+{
+    HostHAL_setConsoleQuiet(true);
+    SystemTime_Initialize();
+    TaskScheduler_Initialize(tasks, sizeof(tasks) / sizeof(tasks[0]));
+    startTicks = SystemTime_ticks();
+
+    for (uint32_t pass = 0; pass < NUM_PASSES; ++pass) {
+        TaskScheduler_task();
+        HostHAL_runTicks(1);
+    }
+
+    HostTest_check(everyPassRuns == NUM_PASSES);
+    HostTest_check(periodicRuns == (NUM_PASSES / SHORT_PERIOD));
+    HostTest_check(periodicIntervalsRight);
+
+    // three busy runs BUSY_DELAY apart, then one period between runs
+    HostTest_check(busyRuns == (BUSY_RUNS + 10));
+    HostTest_check(busyRunTicks[0] == 0);
+    HostTest_check(busyRunTicks[1] == BUSY_DELAY);
+    HostTest_check(busyRunTicks[2] == (2 * BUSY_DELAY));
+    HostTest_check(busyRunTicks[3] == (3 * BUSY_DELAY));
+    HostTest_check(busyRunTicks[4] ==
+        ((3 * BUSY_DELAY) + SYSTEMTIME_TICKS_PER_SECOND));
+    HostTest_check(busyRunTicks[5] ==
+        ((3 * BUSY_DELAY) + (2 * SYSTEMTIME_TICKS_PER_SECOND)));
+
+    return HostTest_finish("TaskSchedulerTest");
+}
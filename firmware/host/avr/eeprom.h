@@ -0,0 +1,11 @@
+//
+//  Host shim for avr/eeprom.h
+//
+//  EEPROM variables are ordinary variables on the host (see HostEEPROM.c)
+//
+#ifndef HOST_AVR_EEPROM_H
+#define HOST_AVR_EEPROM_H
+
+#define EEMEM
+
+#endif  // HOST_AVR_EEPROM_H
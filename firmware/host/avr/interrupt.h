@@ -0,0 +1,24 @@
+//
+//  Host shim for avr/interrupt.h
+//
+//  There are no interrupts on the host. Critical sections still save
+//  and restore SREG, which is an ordinary variable here (see HostHAL.c).
+//  Interrupt handlers become ordinary functions named after their
+//  vector, which host programs call to simulate the interrupt (see
+//  HostHAL_advanceTicks)
+//
+#ifndef HOST_AVR_INTERRUPT_H
+#define HOST_AVR_INTERRUPT_H
+
+#include <avr/io.h>
+
+#define cli()
+#define sei()
+
+#define ISR(vector, ...) void vector (void)
+#define ISR_BLOCK
+
+extern void TIMER3_COMPA_vect (void);
+extern void WDT_vect (void);
+
+#endif  // HOST_AVR_INTERRUPT_H
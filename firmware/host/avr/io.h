@@ -0,0 +1,75 @@
+//
+//  Host shim for avr/io.h
+//
+//  Only the registers used by the host-built modules are declared. They
+//  are ordinary variables here (see HostHAL.c), so writes to them have
+//  no effect and reads return whatever was last written. The exception
+//  is the SPI port, which is modelled well enough to drive the TFT
+//  display (see below).
+//
+#ifndef HOST_AVR_IO_H
+#define HOST_AVR_IO_H
+
+#include <stdint.h>
+
+extern volatile uint8_t SREG;
+
+// ports
+extern volatile uint8_t PORTB;
+extern volatile uint8_t PORTC;
+extern volatile uint8_t PORTD;
+extern volatile uint8_t PORTF;
+extern volatile uint8_t DDRB;
+extern volatile uint8_t DDRD;
+extern volatile uint8_t DDRF;
+extern volatile uint8_t PIND;
+
+#define PB0 0
+#define PB1 1
+#define PB2 2
+#define PB3 3
+#define PB6 6
+#define PB7 7
+#define PD2 2
+#define PD3 3
+#define PD4 4
+#define PD6 6
+#define PF0 0
+#define PF1 1
+
+// SPI. every access to SPDR is taken to be a write, which is sent to the
+// sink set with HostHAL_setSPISink when SPDR or SPSR is next accessed.
+// Transfers complete at once: SPIF always reads as set. The firmware only
+// reads SPDR in the disabled TFT self-test
+extern volatile uint8_t SPCR;
+extern volatile uint8_t* HostHAL_spiDataRegister (void);
+extern volatile uint8_t* HostHAL_spiStatusRegister (void);
+#define SPDR (*HostHAL_spiDataRegister())
+#define SPSR (*HostHAL_spiStatusRegister())
+
+#define SPIF 7
+#define SPE 6
+#define DORD 5
+#define MSTR 4
+#define CPOL 3
+#define CPHA 2
+#define SPR1 1
+#define SPR0 0
+#define SPI2X 0
+
+// timer/counter 3 (SystemTime)
+extern volatile uint8_t TCCR3B;
+extern volatile uint16_t OCR3A;
+extern volatile uint16_t TCNT3;
+extern volatile uint8_t TIFR3;
+extern volatile uint8_t TIMSK3;
+
+#define OCF3A 1
+#define OCIE3A 1
+
+// watchdog
+extern volatile uint8_t WDTCSR;
+
+#define WDIE 6
+
+#endif  // HOST_AVR_IO_H
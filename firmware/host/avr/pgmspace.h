@@ -0,0 +1,48 @@
+//
+//  Host shim for avr/pgmspace.h
+//
+//  On the host there is only one address space, so program memory
+//  accessors are plain reads and the _P string functions are the
+//  ordinary ones.
+//
+#ifndef HOST_AVR_PGMSPACE_H
+#define HOST_AVR_PGMSPACE_H
+
+#include <stdint.h>
+#include <string.h>
+#include <strings.h>
+
+#define PROGMEM
+#define PSTR(s) (s)
+
+typedef const char* PGM_P;
+typedef char prog_char;
+
+#define pgm_read_byte(addr) (*(const uint8_t*)(addr))
+// tables of pointers are read with pgm_read_word on the AVR, where a
+// pointer is 16 bits. read the pointed-to type so pointers stay whole
+#define pgm_read_word(addr) (*(addr))
+
+#define strcmp_P strcmp
+#define strcpy_P strcpy
+#define strlen_P strlen
+#define strstr_P strstr
+#define strncmp_P strncmp
+#define strcasecmp_P strcasecmp
+#define strncasecmp_P strncasecmp
+#define memcpy_P memcpy
+
+// same result as strncpy, without gcc's -Wstringop-truncation analysis of
+// callers that copy part of a string on purpose
+static inline char* strncpy_P (
+    char* dest,
+    PGM_P src,
+    size_t n)
+{
+    const size_t len = strnlen(src, n);
+    memcpy(dest, src, len);
+    memset(dest + len, 0, n - len);
+    return dest;
+}
+
+#endif  // HOST_AVR_PGMSPACE_H
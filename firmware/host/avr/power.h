@@ -0,0 +1,10 @@
+//
+//  Host shim for avr/power.h
+//
+#ifndef HOST_AVR_POWER_H
+#define HOST_AVR_POWER_H
+
+#define power_all_disable()
+#define power_all_enable()
+
+#endif  // HOST_AVR_POWER_H
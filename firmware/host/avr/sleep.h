@@ -0,0 +1,17 @@
+//
+//  Host shim for avr/sleep.h
+//
+//  Sleeping returns right away on the host
+//
+#ifndef HOST_AVR_SLEEP_H
+#define HOST_AVR_SLEEP_H
+
+#define SLEEP_MODE_PWR_DOWN 2
+
+#define set_sleep_mode(mode)
+#define sleep_enable()
+#define sleep_bod_disable()
+#define sleep_cpu()
+#define sleep_disable()
+
+#endif  // HOST_AVR_SLEEP_H
@@ -0,0 +1,17 @@
+//
+//  Host shim for avr/wdt.h
+//
+//  There is no watchdog on the host
+//
+#ifndef HOST_AVR_WDT_H
+#define HOST_AVR_WDT_H
+
+#define WDTO_1S 6
+#define WDTO_2S 7
+#define WDTO_4S 8
+#define WDTO_8S 9
+
+#define wdt_enable(timeout) ((void)(timeout))
+#define wdt_reset()
+
+#endif  // HOST_AVR_WDT_H
@@ -0,0 +1,13 @@
+//
+//  Host shim for util/delay.h
+//
+//  Busy-wait delays are only needed by the hardware, so they do nothing
+//  on the host.
+//
+#ifndef HOST_UTIL_DELAY_H
+#define HOST_UTIL_DELAY_H
+
+#define _delay_us(us) ((void)(us))
+#define _delay_ms(ms) ((void)(ms))
+
+#endif  // HOST_UTIL_DELAY_H